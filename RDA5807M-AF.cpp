@@ -0,0 +1,169 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the Alternative Frequency follower.
+ * See the header file for better function documentation.
+ */
+
+#include "RDA5807M-AF.h"
+
+static byte rssiOf(word reg) {
+    return (reg & RDA5807M_RSSI_MASK) >> RDA5807M_RSSI_SHIFT;
+};
+
+byte RDA5807MAFFollower::service(unsigned long now) {
+    if ((long)(now - next) < 0 || !rds.getAFCount())
+        return RDA5807M_AF_NONE;
+    next = now + interval;
+
+    word home[2];
+
+    radio.getRegisterBulk(2, home);
+    stats.transactions++;
+    if (rssiOf(home[1]) >= threshold)
+        return RDA5807M_AF_NONE;
+
+    return probe(home);
+};
+
+byte RDA5807MAFFollower::probe(void) {
+    word home[2];
+
+    radio.getRegisterBulk(2, home);
+    stats.transactions++;
+
+    return probe(home);
+};
+
+byte RDA5807MAFFollower::probe(const word home[2]) {
+    const byte count = rds.getAFCount();
+    const word pi = rds.getPI();
+    const word config = radio.getShadowRegister(RDA5807M_REG_CONFIG);
+    const word tuning = radio.getShadowRegister(RDA5807M_REG_TUNING) &
+        (RDA5807M_BAND_MASK | RDA5807M_SPACE_MASK);
+    const word blend = radio.getShadowRegister(RDA5807M_REG_BLEND);
+    const byte band = RDA5807MBandIndex(tuning, blend);
+    //Where a seek or a previous switch left us, not what was last written
+    const word channel = home[0] & RDA5807M_READCHAN_MASK;
+    word target = RDA5807M_CHANNEL_INVALID;
+
+    //Direct frequency mode has no channel to come back to, and until a tune
+    //completes neither channel nor RSSI are the home station's
+    if (!count || !pi || (blend & RDA5807M_FLG_FREQMODE) ||
+        !(home[0] & RDA5807M_STATUS_STC))
+        return RDA5807M_AF_NONE;
+
+    for(byte i=0; i < count && target == RDA5807M_CHANNEL_INVALID; i++) {
+        last = last + 1 < count ? last + 1 : 0;
+        target = RDA5807MFrequencyChannel(band, tuning & RDA5807M_SPACE_MASK,
+                                          rds.getAF(last));
+        if (target == channel)
+            target = RDA5807M_CHANNEL_INVALID;
+    };
+    if (target == RDA5807M_CHANNEL_INVALID)
+        return RDA5807M_AF_NONE;
+
+    const byte needed = rssiOf(home[1]) + hysteresis;
+    const unsigned long start = micros();
+    word regs[2];
+    byte result;
+
+    stats.probes++;
+    //Mute and tune in one sequential write of CONFIG and TUNING
+    radio.beginBatch();
+    radio.mute();
+    radio.setTuning(tuning | (target << RDA5807M_CHAN_SHIFT));
+    radio.commit();
+    stats.transactions++;
+
+    if (!settle(regs) || rssiOf(regs[1]) < needed)
+        result = RDA5807M_AF_WEAKER;
+    else if (!waitPI(pi, regs))
+        result = RDA5807M_AF_WRONGPI;
+    else
+        //A dozen more reads in, RSSI has had time to settle too
+        result = rssiOf(regs[1]) < needed ? RDA5807M_AF_WEAKER :
+            RDA5807M_AF_SWITCHED;
+
+    //Audio as it was and, unless staying, the home station in one write
+    if (result == RDA5807M_AF_SWITCHED)
+        radio.setRegister(RDA5807M_REG_CONFIG, config);
+    else {
+        radio.beginBatch();
+        radio.setRegister(RDA5807M_REG_CONFIG, config);
+        radio.setTuning(tuning | (channel << RDA5807M_CHAN_SHIFT));
+        radio.commit();
+    };
+    stats.transactions++;
+
+    const unsigned long muted = micros() - start;
+
+    stats.muteMicros += muted;
+    stats.lastMuteMicros = muted;
+    if (muted > stats.maxMuteMicros)
+        stats.maxMuteMicros = muted;
+    switch (result) {
+        case RDA5807M_AF_WEAKER:
+            stats.weaker++;
+            break;
+        case RDA5807M_AF_WRONGPI:
+            stats.wrongPI++;
+            break;
+        default:
+            stats.switches++;
+    };
+
+    return result;
+};
+
+bool RDA5807MAFFollower::settle(word regs[2]) {
+    word elapsed = dwell;
+
+    delay(dwell);
+    for(;;) {
+        radio.getRegisterBulk(2, regs);
+        stats.transactions++;
+        if (regs[0] & RDA5807M_STATUS_STC)
+            break;
+        if (elapsed >= RDA5807M_AF_TUNE_TIMEOUT_MS)
+            return false;
+        delay(RDA5807M_AF_POLL_MS);
+        elapsed += RDA5807M_AF_POLL_MS;
+    };
+
+    //Took longer: wait that long from now on. Settled in time a number of
+    //probes in a row: see whether less will do.
+    if (elapsed > dwell) {
+        dwell = elapsed;
+        streak = 0;
+    } else if (++streak >= RDA5807M_AF_DWELL_STREAK) {
+        if (dwell > RDA5807M_AF_DWELL_MIN_MS)
+            dwell--;
+        streak = 0;
+    };
+
+    return true;
+};
+
+bool RDA5807MAFFollower::waitPI(word pi, word regs[2]) {
+    word status[RDA5807M_STATUS_SIZE];
+
+    for(word t=0; t < RDA5807M_AF_PI_TIMEOUT_MS; t += RDA5807M_AF_PI_POLL_MS) {
+        delay(RDA5807M_AF_PI_POLL_MS);
+        radio.getRegisterBulk(RDA5807M_STATUS_SIZE, status);
+        stats.transactions++;
+        regs[1] = status[1];
+        //Only trust block A if it needed little or no correction
+        if ((status[0] & RDA5807M_STATUS_RDSR) &&
+            (status[1] & RDA5807M_BLERA_MASK) <= RDA5807M_BLERA_12)
+            return status[2] == pi;
+    };
+
+    return false;
+};
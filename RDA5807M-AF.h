@@ -0,0 +1,162 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the Alternative Frequency follower, which
+ * moves the radio to a stronger transmitter of the same programme, using the
+ * AF list RDS broadcasts in group 0A.
+ */
+
+#ifndef _RDA5807M_AF_H_INCLUDED
+#define _RDA5807M_AF_H_INCLUDED
+
+#include "RDA5807M.h"
+#include "RDA5807M-RDS.h"
+
+//Defaults, in RSSI units and milliseconds: switch to an AF at least
+//HYSTERESIS stronger, only look for one below THRESHOLD and then only every
+//INTERVAL.
+#define RDA5807M_AF_HYSTERESIS 6
+#define RDA5807M_AF_THRESHOLD 40
+#define RDA5807M_AF_INTERVAL_MS 2000
+
+//Probe pacing, in milliseconds. The dwell before the first read after
+//tuning starts at DWELL and then follows what the chip actually needs, but
+//never goes under DWELL_MIN.
+#define RDA5807M_AF_DWELL_MS 10
+#define RDA5807M_AF_DWELL_MIN_MS 2
+//Probes in a row settled by the first read before the dwell is shortened
+#define RDA5807M_AF_DWELL_STREAK 8
+#define RDA5807M_AF_POLL_MS 1
+#define RDA5807M_AF_TUNE_TIMEOUT_MS 100
+#define RDA5807M_AF_PI_POLL_MS 20
+#define RDA5807M_AF_PI_TIMEOUT_MS 500
+
+//Probe outcomes, see RDA5807MAFFollower::probe()
+#define RDA5807M_AF_NONE 0x0 //Nothing to probe
+#define RDA5807M_AF_WEAKER 0x1 //Not stronger by the hysteresis, back home
+#define RDA5807M_AF_WRONGPI 0x2 //Other programme or no PI in time, back home
+#define RDA5807M_AF_SWITCHED 0x3 //Now on the AF
+
+//What the follower did, see RDA5807MAFFollower::getStats().
+typedef struct {
+    unsigned long probes;
+    unsigned long switches;
+    unsigned long weaker;
+    unsigned long wrongPI;
+    unsigned long transactions; //Bus transactions spent probing
+    unsigned long muteMicros; //Total time muted, in microseconds
+    unsigned long lastMuteMicros; //Of the last probe
+    unsigned long maxMuteMicros;
+} TRDA5807MAFStats;
+
+/*
+ * Follows the AF list of the station the radio is on, as decoded by an
+ * RDA5807MRDS instance fed by the sketch. While the signal is weak, service()
+ * probes one AF at a time. A probe is:
+ * - one write muting the audio and tuning to the AF;
+ * - usually one read of STATUS and RSSI, once the chip should have settled;
+ * - and, back on the home station, one write restoring tuning and audio.
+ * Only an AF that is stronger by the hysteresis gets the longer check: the
+ * probe waits, still muted, for an RDS group with the expected PI, and
+ * stays there if it comes.
+ *
+ * Probes block for their duration, like RDA5807M::scan(), and leave the
+ * tuning engine running, so the tune callback fires when it settles.
+ */
+class RDA5807MAFFollower
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, for the given radio and the RDS decoder
+        *   fed from it.
+        */
+        RDA5807MAFFollower(RDA5807M &radio, RDA5807MRDS &rds) :
+            radio(radio), rds(rds), hysteresis(RDA5807M_AF_HYSTERESIS),
+            threshold(RDA5807M_AF_THRESHOLD),
+            interval(RDA5807M_AF_INTERVAL_MS), dwell(RDA5807M_AF_DWELL_MS),
+            streak(0), next(0), last(0xFF) {
+            clearStats();
+        };
+
+        /*
+        * Description:
+        *   Tuning parameters: RSSI margin an AF needs over the home station,
+        *   home RSSI from which on AFs aren't looked for and time between
+        *   probes, in milliseconds.
+        */
+        void setHysteresis(byte rssi) { hysteresis = rssi; };
+        void setThreshold(byte rssi) { threshold = rssi; };
+        void setInterval(word ms) { interval = ms; };
+
+        /*
+        * Description:
+        *   Probes the next AF if it's time to and the home station is weak,
+        *   call from the main loop.
+        * Parameters:
+        *   now - current time in milliseconds, as returned by millis().
+        * Returns:
+        *   what the probe found, one of the RDA5807M_AF_* constants.
+        */
+        byte service(unsigned long now);
+        byte service(void) { return service(millis()); };
+
+        /*
+        * Description:
+        *   Probes the next AF on the list right away, whatever the home
+        *   station's RSSI.
+        * Returns:
+        *   what the probe found, one of the RDA5807M_AF_* constants.
+        */
+        byte probe(void);
+
+        /*
+        * Description:
+        *   Current dwell before the first read after tuning, in
+        *   milliseconds.
+        */
+        byte getDwell(void) { return dwell; };
+
+        const TRDA5807MAFStats &getStats(void) { return stats; };
+        void clearStats(void) { memset(&stats, 0x00, sizeof(stats)); };
+
+    private:
+        RDA5807M &radio;
+        RDA5807MRDS &rds;
+        byte hysteresis, threshold;
+        word interval;
+        byte dwell, streak;
+        unsigned long next; //When the next probe is due, in millis()
+        byte last; //AF list entry probed last
+        TRDA5807MAFStats stats;
+
+        /*
+        * Description:
+        *   Probes the next AF, given STATUS and RSSI of the home station.
+        */
+        byte probe(const word home[2]);
+
+        /*
+        * Description:
+        *   Waits for the chip to settle on a tune and reads STATUS and RSSI,
+        *   adjusting the dwell to what it took.
+        * Returns:
+        *   false if it didn't settle in time.
+        */
+        bool settle(word regs[2]);
+
+        /*
+        * Description:
+        *   Waits for an RDS group with the given PI, keeping regs[1] up to
+        *   date with RSSI.
+        */
+        bool waitPI(word pi, word regs[2]);
+};
+
+#endif
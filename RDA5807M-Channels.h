@@ -0,0 +1,179 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file contains the band plan and the channel <-> frequency arithmetic.
+ * Everything here is constexpr, so it folds away when band and spacing are
+ * known at compile time and costs no division when they aren't: all four
+ * channel spacings are 25kHz times a power of two, which leaves a division
+ * by 5 that is done as a multiplication by its reciprocal.
+ */
+
+#ifndef _RDA5807M_CHANNELS_H_INCLUDED
+#define _RDA5807M_CHANNELS_H_INCLUDED
+
+//Band plan indices: RDA5807M_BAND_* >> RDA5807M_BAND_SHIFT, plus the 50MHz
+//variant of RDA5807M_BAND_EAST selected by clearing RDA5807M_FLG_EASTBAND65M.
+#define RDA5807M_BANDS 5
+#define RDA5807M_BAND_EAST_50M 4
+
+//Returned for frequencies outside the band or off the channel raster
+#define RDA5807M_CHANNEL_INVALID 0xFFFF
+//Highest channel number RDA5807M_CHAN_MASK can hold: 25kHz spacing on
+//RDA5807M_BAND_WORLD stops short of the top of the band
+#define RDA5807M_CHANNEL_MAX (RDA5807M_CHAN_MASK >> RDA5807M_CHAN_SHIFT)
+
+/*
+* Description:
+*   Band plan index for the given contents of RDA5807M_REG_TUNING and
+*   RDA5807M_REG_BLEND.
+*/
+constexpr byte RDA5807MBandIndex(word tuning, word blend) {
+    //Not RDA5807M_BAND_MASK: word() isn't constexpr on Arduino
+    return ((tuning >> RDA5807M_BAND_SHIFT) & 0x3) ==
+        (RDA5807M_BAND_EAST >> RDA5807M_BAND_SHIFT) &&
+        !(blend & RDA5807M_FLG_EASTBAND65M) ? RDA5807M_BAND_EAST_50M :
+        (tuning >> RDA5807M_BAND_SHIFT) & 0x3;
+};
+
+/*
+* Description:
+*   Band limits, in 10kHz units, for the given band plan index.
+*/
+constexpr word RDA5807MBandLowerLimit(byte band) {
+    return band == 0 ? 8700 : band < 3 ? 7600 : band == 3 ? 6500 : 5000;
+};
+constexpr word RDA5807MBandHigherLimit(byte band) {
+    return band == 0 || band == 2 ? 10800 : band == 1 ? 9100 :
+        band == 3 ? 7600 : 6500;
+};
+
+/*
+* Description:
+*   Channel spacing for the given RDA5807M_SPACE_* value, as a left shift
+*   of 25kHz (100, 200, 50 and 25kHz are 2, 3, 1 and 0) and in kHz.
+*/
+constexpr byte RDA5807MSpacingShift(byte space) {
+    return (0x1E >> (space << 1)) & 0x3;
+};
+constexpr byte RDA5807MSpacing(byte space) {
+    return 25 << RDA5807MSpacingShift(space);
+};
+
+//value / 5 for any 16-bit value, without a division
+constexpr word RDA5807MDivideBy5(word value) {
+    return ((unsigned long)value * 0xCCCDUL) >> 18;
+};
+
+//Offset (in 10kHz units) of channel from the lower band limit: the channel
+//times 2.5 << shift, rounded down.
+constexpr word RDA5807MChannelOffset(word channel, byte space) {
+    return (word)((word)(channel << RDA5807MSpacingShift(space)) * 5U) >> 1;
+};
+
+//Inverse of the above: with twice the offset being quarter channels of
+//25kHz, it's a channel if that divides by 5 << shift.
+constexpr word RDA5807MCheckChannel(word doubled, word quotient, byte shift) {
+    return quotient * 5 == doubled && !(quotient & ((1 << shift) - 1)) ?
+        quotient >> shift : RDA5807M_CHANNEL_INVALID;
+};
+constexpr word RDA5807MReachableChannel(word channel) {
+    return channel > RDA5807M_CHANNEL_MAX ? RDA5807M_CHANNEL_INVALID : channel;
+};
+constexpr word RDA5807MOffsetChannel(word offset, byte space) {
+    return RDA5807MReachableChannel(
+        RDA5807MCheckChannel(offset << 1, RDA5807MDivideBy5(offset << 1),
+                             RDA5807MSpacingShift(space)));
+};
+
+/*
+* Description:
+*   Frequency, in 10kHz units, of the given channel.
+* Parameters:
+*   band    - band plan index, see RDA5807MBandIndex().
+*   space   - one of the RDA5807M_SPACE_* constants.
+*   channel - channel number, as in RDA5807M_CHAN_MASK.
+*/
+constexpr word RDA5807MChannelFrequency(byte band, byte space, word channel) {
+    return RDA5807MBandLowerLimit(band) + RDA5807MChannelOffset(channel, space);
+};
+
+/*
+* Description:
+*   Channel number for the given frequency, in 10kHz units.
+* Parameters:
+*   band      - band plan index, see RDA5807MBandIndex().
+*   space     - one of the RDA5807M_SPACE_* constants.
+*   frequency - in 10kHz units.
+* Returns:
+*   the channel or RDA5807M_CHANNEL_INVALID if frequency lies outside the band,
+*   between channels or above RDA5807M_CHANNEL_MAX.
+*/
+constexpr word RDA5807MFrequencyChannel(byte band, byte space,
+                                        word frequency) {
+    return frequency < RDA5807MBandLowerLimit(band) ||
+        frequency > RDA5807MBandHigherLimit(band) ? RDA5807M_CHANNEL_INVALID :
+        RDA5807MOffsetChannel(frequency - RDA5807MBandLowerLimit(band), space);
+};
+
+/*
+* Description:
+*   Direct frequency mode: RDA5807M_REG_FREQ holds the offset from the lower
+*   band limit in kHz. The frequency it tunes to and the other way round, in
+*   10kHz units.
+*/
+constexpr word RDA5807MDirectFrequency(byte band, word offset) {
+    return RDA5807MBandLowerLimit(band) + (RDA5807MDivideBy5(offset) >> 1);
+};
+constexpr word RDA5807MDirectOffset(byte band, word frequency) {
+    return (frequency - RDA5807MBandLowerLimit(band)) * 10;
+};
+
+/*
+* Description:
+*   Highest channel number inside the given band, up to RDA5807M_CHANNEL_MAX.
+*/
+constexpr word RDA5807MCapChannel(word channel) {
+    return channel > RDA5807M_CHANNEL_MAX ? RDA5807M_CHANNEL_MAX : channel;
+};
+constexpr word RDA5807MLastChannel(byte band, byte space) {
+    return RDA5807MCapChannel(
+        RDA5807MDivideBy5((RDA5807MBandHigherLimit(band) -
+                           RDA5807MBandLowerLimit(band)) << 1) >>
+        RDA5807MSpacingShift(space));
+};
+
+/*
+ * The same mapping with band and spacing fixed at compile time, e.g.
+ * RDA5807MChannelMap<RDA5807M_BAND_WEST >> RDA5807M_BAND_SHIFT,
+ * RDA5807M_SPACE_100K>::channelOf(10110) is the constant 141.
+ */
+template <byte band, byte space>
+struct RDA5807MChannelMap
+{
+    static_assert(band < RDA5807M_BANDS, "no such band");
+    static_assert(space <= RDA5807M_SPACE_25K, "no such channel spacing");
+
+    static constexpr word lowerLimit(void) {
+        return RDA5807MBandLowerLimit(band);
+    };
+    static constexpr word higherLimit(void) {
+        return RDA5807MBandHigherLimit(band);
+    };
+    static constexpr word lastChannel(void) {
+        return RDA5807MLastChannel(band, space);
+    };
+    static constexpr word frequencyOf(word channel) {
+        return RDA5807MChannelFrequency(band, space, channel);
+    };
+    static constexpr word channelOf(word frequency) {
+        return RDA5807MFrequencyChannel(band, space, frequency);
+    };
+};
+
+#endif
@@ -0,0 +1,404 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the command queue. It compiles to nothing on
+ * Arduino.
+ * See the header file for better function documentation.
+ */
+
+#if !defined(ARDUINO)
+
+#include "RDA5807M-Commands.h"
+
+#include <chrono>
+
+//Commands
+#define COMMAND_REGISTER 0
+#define COMMAND_VOLUME 1
+#define COMMAND_MUTE 2
+#define COMMAND_UNMUTE 3
+#define COMMAND_SETFREQUENCY 4
+#define COMMAND_SEEKUP 5
+#define COMMAND_SEEKDOWN 6
+#define COMMAND_GETFREQUENCY 7
+#define COMMAND_GETRSSI 8
+#define COMMAND_ISSTEREO 9
+#define COMMAND_CALL 10
+
+//What absorbs what: the register for register commands, one key each for
+//the others. COMMAND_KEY_NONE absorbs nothing.
+#define COMMAND_KEY_NONE 0x0000
+#define COMMAND_KEY_REGISTER(reg) (0x0100 | (reg))
+#define COMMAND_KEY_VOLUME 0x0200
+#define COMMAND_KEY_MUTE 0x0300
+#define COMMAND_KEY_TUNE 0x0400
+#define COMMAND_KEY_READ(op) (0x0500 | (op))
+
+//Registers touched or read, the status registers all being one
+#define COMMAND_REG(reg) word(1 << (reg))
+#define COMMAND_STATUS COMMAND_REG(RDA5807M_REG_STATUS)
+#define COMMAND_ALL word(0xFFFF)
+//A tune writes TUNING (and may leave direct frequency mode) and changes
+//what the status registers say. Seeks also set bits of CONFIG no other
+//command but a register one sets, which already conflicts through STATUS.
+#define COMMAND_TUNE_TOUCHES (COMMAND_REG(RDA5807M_REG_TUNING) | \
+                              COMMAND_REG(RDA5807M_REG_BLEND) | \
+                              COMMAND_REG(RDA5807M_REG_FREQ) | COMMAND_STATUS)
+
+static unsigned long long wallMicros(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+static word registerTouches(byte reg) {
+    //Writes to anything but the shadowed registers may do anything at all
+    if (reg < RDA5807M_REG_CONFIG || reg > RDA5807M_REG_FREQ)
+        return COMMAND_ALL;
+
+    return COMMAND_REG(reg) | COMMAND_STATUS;
+};
+
+RDA5807MCommandQueue::RDA5807MCommandQueue(RDA5807M &radio) :
+    radio(radio), head(0), depth(0), busy(false), quit(false) {
+    clearStats();
+    worker = std::thread(&RDA5807MCommandQueue::work, this);
+};
+
+RDA5807MCommandQueue::~RDA5807MCommandQueue() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    };
+    wake.notify_all();
+    worker.join();
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::setRegister(byte reg,
+                                                         word value) {
+    TCommand command(COMMAND_REGISTER, COMMAND_KEY_REGISTER(reg),
+                     registerTouches(reg), 0, 0xFFFF, value);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::updateRegister(byte reg,
+                                                            word mask,
+                                                            word value) {
+    TCommand command(COMMAND_REGISTER, COMMAND_KEY_REGISTER(reg),
+                     registerTouches(reg), 0, mask, value & mask);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::volumeUp(void) {
+    TCommand command(COMMAND_VOLUME, COMMAND_KEY_VOLUME,
+                     COMMAND_REG(RDA5807M_REG_VOLUME), 0, 0, 0, 1);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::volumeDown(void) {
+    TCommand command(COMMAND_VOLUME, COMMAND_KEY_VOLUME,
+                     COMMAND_REG(RDA5807M_REG_VOLUME), 0, 0, 0, -1);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::setVolume(byte volume) {
+    TCommand command(COMMAND_VOLUME, COMMAND_KEY_VOLUME,
+                     COMMAND_REG(RDA5807M_REG_VOLUME), 0,
+                     RDA5807M_VOLUME_MASK, volume & RDA5807M_VOLUME_MASK);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::mute(void) {
+    TCommand command(COMMAND_MUTE, COMMAND_KEY_MUTE,
+                     COMMAND_REG(RDA5807M_REG_CONFIG));
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::unMute(void) {
+    TCommand command(COMMAND_UNMUTE, COMMAND_KEY_MUTE,
+                     COMMAND_REG(RDA5807M_REG_CONFIG));
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::setFrequency(word frequency) {
+    TCommand command(COMMAND_SETFREQUENCY, COMMAND_KEY_TUNE,
+                     COMMAND_TUNE_TOUCHES, 0, 0, frequency);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::seekUp(bool wrap) {
+    TCommand command(COMMAND_SEEKUP, COMMAND_KEY_TUNE, COMMAND_TUNE_TOUCHES,
+                     0, 0, wrap);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::seekDown(bool wrap) {
+    TCommand command(COMMAND_SEEKDOWN, COMMAND_KEY_TUNE,
+                     COMMAND_TUNE_TOUCHES, 0, 0, wrap);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::getFrequency(void) {
+    TCommand command(COMMAND_GETFREQUENCY,
+                     COMMAND_KEY_READ(COMMAND_GETFREQUENCY), 0,
+                     COMMAND_STATUS);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::getRSSI(void) {
+    TCommand command(COMMAND_GETRSSI, COMMAND_KEY_READ(COMMAND_GETRSSI), 0,
+                     COMMAND_STATUS);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::isStereo(void) {
+    TCommand command(COMMAND_ISSTEREO, COMMAND_KEY_READ(COMMAND_ISSTEREO), 0,
+                     COMMAND_STATUS);
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::call(TRDA5807MCommandTask *task,
+                                                  void *context) {
+    TCommand command(COMMAND_CALL, COMMAND_KEY_NONE, COMMAND_ALL,
+                     COMMAND_ALL);
+
+    command.task = task;
+    command.context = context;
+
+    return submit(command);
+};
+
+TRDA5807MCommandResult RDA5807MCommandQueue::submit(TCommand &command) {
+    std::unique_lock<std::mutex> guard(lock);
+
+    command.first = command.total = wallMicros();
+    command.count = 1;
+    stats.submitted++;
+    for(bool waited = false;; waited = true) {
+        //Newest first, up to the first command it mustn't move past
+        for(byte i = depth; i && command.key != COMMAND_KEY_NONE; i--) {
+            TCommand &queued = queue[(head + i - 1) % RDA5807M_COMMANDS_DEPTH];
+
+            if (queued.key == command.key) {
+                if (!absorbs(queued, command))
+                    break;
+                merge(queued, command);
+                stats.coalesced++;
+
+                return queued.result;
+            };
+            if ((queued.touches & (command.touches | command.reads)) ||
+                (queued.reads & command.touches))
+                break;
+        };
+        if (depth < RDA5807M_COMMANDS_DEPTH)
+            break;
+        //Full: wait, and look again as what's queued will have changed
+        if (!waited)
+            stats.waits++;
+        room.wait(guard);
+    };
+
+    TCommand &slot = queue[(head + depth) % RDA5807M_COMMANDS_DEPTH];
+
+    slot = std::move(command);
+    slot.result = slot.promise.get_future().share();
+    if (++depth > stats.maxDepth)
+        stats.maxDepth = depth;
+    wake.notify_one();
+
+    return slot.result;
+};
+
+bool RDA5807MCommandQueue::absorbs(const TCommand &queued,
+                                   const TCommand &later) {
+    //Volume steps only add up while they go the same way, a clamp in between
+    //would be lost otherwise: at 15, up then down is 14, not 15
+    return queued.op != COMMAND_VOLUME || later.mask || !queued.delta ||
+        (queued.delta > 0) == (later.delta > 0);
+};
+
+void RDA5807MCommandQueue::merge(TCommand &queued, TCommand &later) {
+    switch (queued.op) {
+        case COMMAND_REGISTER:
+            queued.value = (queued.value & ~later.mask) | later.value;
+            queued.mask |= later.mask;
+            break;
+        case COMMAND_VOLUME:
+            if (later.mask) {
+                queued.mask = later.mask;
+                queued.value = later.value;
+                queued.delta = 0;
+            };
+            queued.delta += later.delta;
+            break;
+        case COMMAND_GETFREQUENCY:
+        case COMMAND_GETRSSI:
+        case COMMAND_ISSTEREO:
+            break;
+        default:
+            //Mute and tune: the last one wins
+            queued.op = later.op;
+            queued.value = later.value;
+    };
+    queued.total += later.total;
+    queued.count++;
+};
+
+void RDA5807MCommandQueue::flush(void) {
+    std::unique_lock<std::mutex> guard(lock);
+
+    idle.wait(guard, [this] { return !depth && !busy; });
+};
+
+TRDA5807MCommandStats RDA5807MCommandQueue::getStats(void) {
+    std::lock_guard<std::mutex> guard(lock);
+    TRDA5807MCommandStats result = stats;
+
+    result.elapsedMicros = wallMicros() - since;
+
+    return result;
+};
+
+void RDA5807MCommandQueue::clearStats(void) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    memset(&stats, 0x00, sizeof(stats));
+    since = wallMicros();
+};
+
+void RDA5807MCommandQueue::work(void) {
+    std::unique_lock<std::mutex> guard(lock);
+
+    for(;;) {
+        const byte tuner = radio.getTunerState();
+        const bool tuning = tuner == RDA5807M_TUNER_TUNING ||
+            tuner == RDA5807M_TUNER_SEEKING;
+
+        if (!depth) {
+            busy = false;
+            idle.notify_all();
+            if (quit)
+                return;
+            if (tuning) {
+                guard.unlock();
+                delay(RDA5807M_COMMANDS_POLL_MS);
+                radio.poll();
+                guard.lock();
+            } else
+                wake.wait(guard);
+            continue;
+        };
+
+        TCommand command = std::move(queue[head]);
+        const unsigned long long start = wallMicros();
+
+        queue[head] = TCommand();
+        head = (head + 1) % RDA5807M_COMMANDS_DEPTH;
+        depth--;
+        busy = true;
+        room.notify_one();
+
+        //Coalesced submissions go in the histogram at their average
+        const unsigned long long waited = start * command.count -
+            command.total;
+        byte bucket = 0;
+
+        for(unsigned long long limit = RDA5807M_COMMANDS_HISTOGRAM_BASE;
+            bucket < RDA5807M_COMMANDS_HISTOGRAM_BUCKETS - 1 &&
+            waited / command.count >= limit; limit <<= 1)
+            bucket++;
+        stats.histogram[bucket] += command.count;
+        stats.latencyMicros += waited;
+        if (start - command.first > stats.maxLatencyMicros)
+            stats.maxLatencyMicros = start - command.first;
+
+        guard.unlock();
+
+        const word result = run(command);
+
+        if (tuning)
+            radio.poll();
+
+        const unsigned long long end = wallMicros();
+
+        //Counted before anybody waiting on it gets to look at the statistics
+        guard.lock();
+        stats.executed++;
+        stats.busyMicros += end - start;
+        command.promise.set_value(result);
+    };
+};
+
+word RDA5807MCommandQueue::run(TCommand &command) {
+    switch (command.op) {
+        case COMMAND_REGISTER: {
+            const byte reg = lowByte(command.key);
+
+            if (command.mask == 0xFFFF)
+                radio.setRegister(reg, command.value);
+            else
+                radio.updateRegister(reg, command.mask, command.value);
+
+            return radio.getShadowRegister(reg);
+        };
+        case COMMAND_VOLUME: {
+            const int current = radio.getShadowRegister(RDA5807M_REG_VOLUME) &
+                RDA5807M_VOLUME_MASK;
+            int volume = (command.mask ? command.value : current) +
+                command.delta;
+
+            if (volume < 0)
+                volume = 0;
+            else if (volume > RDA5807M_VOLUME_MASK)
+                volume = RDA5807M_VOLUME_MASK;
+            if (volume != current)
+                radio.updateRegister(RDA5807M_REG_VOLUME,
+                                     RDA5807M_VOLUME_MASK, volume);
+
+            return volume;
+        };
+        case COMMAND_MUTE:
+            radio.mute();
+            return 0;
+        case COMMAND_UNMUTE:
+            radio.unMute();
+            return 0;
+        case COMMAND_SETFREQUENCY:
+            return radio.setFrequency(command.value);
+        case COMMAND_SEEKUP:
+            radio.seekUp(command.value);
+            return 0;
+        case COMMAND_SEEKDOWN:
+            radio.seekDown(command.value);
+            return 0;
+        case COMMAND_GETFREQUENCY:
+            return radio.getFrequency();
+        case COMMAND_GETRSSI:
+            return radio.getRSSI();
+        case COMMAND_ISSTEREO:
+            return radio.isStereo();
+        default:
+            return command.task(radio, command.context);
+    };
+};
+
+#endif
@@ -0,0 +1,211 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the command queue, which lets several threads
+ * share one radio by handing operations to a single thread that owns it. It
+ * needs threads and is only available on a host (ARDUINO not defined).
+ */
+
+#ifndef _RDA5807M_COMMANDS_H_INCLUDED
+#define _RDA5807M_COMMANDS_H_INCLUDED
+
+#include "RDA5807M.h"
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+//Capacity: commands waiting at most, submitting more waits for room
+#if !defined(RDA5807M_COMMANDS_DEPTH)
+# define RDA5807M_COMMANDS_DEPTH 32
+#endif
+
+//How often the owner thread runs the tuning engine while a tune or seek is
+//under way, in milliseconds
+#define RDA5807M_COMMANDS_POLL_MS 1
+
+//Queueing latency histogram, same layout as the instrumentation's: bucket 0
+//holds commands started less than RDA5807M_COMMANDS_HISTOGRAM_BASE
+//microseconds after being submitted, each following one twice as long a
+//range and the last one everything above.
+#define RDA5807M_COMMANDS_HISTOGRAM_BUCKETS 12
+#define RDA5807M_COMMANDS_HISTOGRAM_BASE 16
+
+//Result of a command: what the matching RDA5807M method returns (bool as 0
+//or 1, nothing as 0), or as documented below. Coalesced commands all get
+//the result of the one that ran.
+typedef std::shared_future<word> TRDA5807MCommandResult;
+
+//Function run on the radio by RDA5807MCommandQueue::call(), returning the
+//command's result.
+typedef word TRDA5807MCommandTask(RDA5807M &radio, void *context);
+
+//Work done by the queue since the last clearStats().
+typedef struct {
+    unsigned long submitted;
+    unsigned long executed; //Commands run on the radio
+    unsigned long coalesced; //Submitted, but folded into a queued command
+    unsigned long waits; //Submissions that had to wait for room
+    byte maxDepth; //Most commands waiting at once
+    //Submission to start of execution, in microseconds of wall time
+    unsigned long long latencyMicros; //Total, over every submission
+    unsigned long maxLatencyMicros;
+    unsigned long histogram[RDA5807M_COMMANDS_HISTOGRAM_BUCKETS];
+    unsigned long long busyMicros; //Spent executing
+    unsigned long long elapsedMicros; //Since clearStats()
+} TRDA5807MCommandStats;
+
+/*
+ * Owns an RDA5807M on behalf of any number of threads. Every method queues a
+ * command and returns at once with a future for its result; a worker thread
+ * runs the commands on the radio, one at a time, so read-modify-write
+ * sequences from different threads can't interleave. The radio must not be
+ * used directly while the queue exists, and the queue doesn't begin() or
+ * end() it: do either with call().
+ *
+ * Before it runs, a command absorbs later ones of the same kind, as long as
+ * nothing queued in between touches the same registers:
+ * - volumeUp(), volumeDown() and setVolume() add up to a single write, as
+ *   long as the steps all go the same way;
+ * - mute() and unMute(): the last one wins;
+ * - setFrequency(), seekUp() and seekDown(): the last one wins;
+ * - setRegister() and updateRegister() on the same register merge into one
+ *   update, later bits taking precedence;
+ * - the same read (getFrequency(), getRSSI(), isStereo()) is done once.
+ * call() absorbs nothing and nothing moves past it.
+ *
+ * While a tune or seek is under way, the worker runs the tuning engine (see
+ * RDA5807M::tick()) between commands, so callbacks set on the radio are
+ * called from the worker thread.
+ */
+class RDA5807MCommandQueue
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, it starts the worker for the given radio.
+        */
+        RDA5807MCommandQueue(RDA5807M &radio);
+
+        /*
+        * Description:
+        *   This is the destructor, it runs whatever is still queued and stops
+        *   the worker.
+        */
+        ~RDA5807MCommandQueue();
+
+        /*
+        * Description:
+        *   As for RDA5807M. Results are the register's new value for
+        *   setRegister() and updateRegister() and the new volume for
+        *   volumeUp(), volumeDown() and setVolume(), which steps the volume
+        *   only once per coalesced batch, clamped to 0 to 15. setFrequency()
+        *   and the seeks return once the tune has started.
+        */
+        TRDA5807MCommandResult setRegister(byte reg, word value);
+        TRDA5807MCommandResult updateRegister(byte reg, word mask, word value);
+        TRDA5807MCommandResult volumeUp(void);
+        TRDA5807MCommandResult volumeDown(void);
+        TRDA5807MCommandResult setVolume(byte volume);
+        TRDA5807MCommandResult mute(void);
+        TRDA5807MCommandResult unMute(void);
+        TRDA5807MCommandResult setFrequency(word frequency);
+        TRDA5807MCommandResult seekUp(bool wrap = true);
+        TRDA5807MCommandResult seekDown(bool wrap = true);
+        TRDA5807MCommandResult getFrequency(void);
+        TRDA5807MCommandResult getRSSI(void);
+        TRDA5807MCommandResult isStereo(void);
+
+        /*
+        * Description:
+        *   Runs anything else on the radio, on the worker thread, in order.
+        */
+        TRDA5807MCommandResult call(TRDA5807MCommandTask *task,
+                                    void *context);
+
+        /*
+        * Description:
+        *   Waits until everything submitted so far has run.
+        */
+        void flush(void);
+
+        /*
+        * Description:
+        *   Throughput and queueing latency so far.
+        */
+        TRDA5807MCommandStats getStats(void);
+        void clearStats(void);
+
+    private:
+        //One queued command. key says what it can absorb, touches which
+        //registers it writes (bit n for register n, STATUS for the status
+        //registers) and reads which ones it reads.
+        struct TCommand {
+            TCommand(byte op = 0, word key = 0, word touches = 0,
+                     word reads = 0, word mask = 0, word value = 0,
+                     int delta = 0) :
+                op(op), key(key), touches(touches), reads(reads), mask(mask),
+                value(value), delta(delta), task(NULL), context(NULL), first(0),
+                total(0), count(0) {};
+
+            byte op;
+            word key;
+            word touches, reads;
+            //Register bits and value, volume (if mask is set), frequency or
+            //seek wrap
+            word mask, value;
+            int delta; //Volume steps, on top of the above
+            TRDA5807MCommandTask *task;
+            void *context;
+            std::promise<word> promise;
+            TRDA5807MCommandResult result;
+            unsigned long long first; //Earliest submission
+            unsigned long long total; //Sum of submission times
+            word count; //Submissions folded in
+        };
+
+        RDA5807M &radio;
+        std::thread worker;
+        std::mutex lock;
+        std::condition_variable wake, room, idle;
+        TCommand queue[RDA5807M_COMMANDS_DEPTH];
+        byte head, depth;
+        bool busy, quit;
+        unsigned long long since; //When the statistics were cleared
+        TRDA5807MCommandStats stats;
+
+        /*
+        * Description:
+        *   Queues a command, or folds it into a queued one.
+        */
+        TRDA5807MCommandResult submit(TCommand &command);
+
+        /*
+        * Description:
+        *   Whether queued, which has the same key, can absorb later with
+        *   the same outcome as running both.
+        */
+        static bool absorbs(const TCommand &queued, const TCommand &later);
+
+        /*
+        * Description:
+        *   Folds later into queued, which has the same key.
+        */
+        static void merge(TCommand &queued, TCommand &later);
+
+        /*
+        * Description:
+        *   Worker thread, and what it does with one command.
+        */
+        void work(void);
+        word run(TCommand &command);
+};
+
+#endif
@@ -0,0 +1,143 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the C++20 coroutine interface. It compiles to
+ * nothing on Arduino or without coroutine support.
+ * See the header file for better function documentation.
+ */
+
+#include "RDA5807M-Coroutine.h"
+
+#if !defined(ARDUINO) && defined(__cpp_impl_coroutine)
+
+#include "RDA5807M-private.h"
+
+//How long, in milliseconds, a radio in interrupt mode waits for RDS before
+//reading the chip anyway, in case an edge got lost
+#define CORO_RDS_TIMEOUT_MS 1000
+
+void RDA5807MWaiter::await_suspend(std::coroutine_handle<> handle) {
+    this->handle = handle;
+    due = micros() + delay;
+    next = scheduler.waiters;
+    scheduler.waiters = this;
+};
+
+RDA5807MTuneWaiter RDA5807MAsync::tune(word frequency) {
+    RDA5807MTuneWaiter waiter(scheduler, this, RDA5807M_WAIT_TUNER,
+                              RDA5807M_TUNE_SETTLE_MS * 1000UL);
+
+    irq = false;
+    waiter.state = radio.setFrequency(frequency) ? RDA5807M_TUNER_TUNING :
+        RDA5807M_TUNER_FAILED;
+
+    return waiter;
+};
+
+RDA5807MTuneWaiter RDA5807MAsync::seek(bool up, bool wrap) {
+    irq = false;
+    if (up)
+        radio.seekUp(wrap);
+    else
+        radio.seekDown(wrap);
+
+    return RDA5807MTuneWaiter(scheduler, this, RDA5807M_WAIT_TUNER,
+                              RDA5807M_SEEK_SETTLE_MS * 1000UL);
+};
+
+bool RDA5807MScheduler::step(RDA5807MWaiter &waiter, unsigned long now) {
+    if (waiter.kind == RDA5807M_WAIT_SLEEP)
+        return true;
+
+    RDA5807M &radio = waiter.radio->radio;
+    const bool interrupts = radio.isInterruptMode();
+
+    stats.polls++;
+    if (waiter.kind == RDA5807M_WAIT_RDS) {
+        waiter.radio->irq = false;
+        waiter.status = radio.getStatus();
+        if (waiter.status.status & RDA5807M_STATUS_RDSR)
+            return true;
+        waiter.due = now + (interrupts ? CORO_RDS_TIMEOUT_MS :
+                            RDA5807M_CORO_RDS_POLL_MS) * 1000UL;
+
+        return false;
+    };
+
+    //The driver itself stays off the bus in interrupt mode until told about
+    //an edge or a timeout is due
+    if (waiter.radio->irq.exchange(false))
+        radio.handleInterrupt();
+    waiter.state = radio.poll();
+    if (waiter.state != RDA5807M_TUNER_TUNING &&
+        waiter.state != RDA5807M_TUNER_SEEKING)
+        return true;
+
+    const bool seeking = waiter.state == RDA5807M_TUNER_SEEKING;
+
+    if (interrupts)
+        waiter.due = now + (seeking ? RDA5807M_SEEK_TIMEOUT_MS :
+                            RDA5807M_TUNE_TIMEOUT_MS) * 1000UL;
+    else
+        waiter.due = now + (seeking ? RDA5807M_SEEK_POLL_MS :
+                            RDA5807M_TUNE_POLL_MS) * 1000UL;
+
+    return false;
+};
+
+unsigned long RDA5807MScheduler::runOnce(void) {
+    for(;;) {
+        const unsigned long now = micros();
+        unsigned long wait = 0xFFFFFFFFUL;
+        RDA5807MWaiter **link;
+
+        if (!waiters)
+            return 0;
+
+        for(link = &waiters; *link; link = &(*link)->next) {
+            RDA5807MWaiter &waiter = **link;
+            const bool edge = waiter.radio && waiter.radio->irq;
+
+            if (edge)
+                stats.interrupts++;
+            if ((edge || (long)(now - waiter.due) >= 0) &&
+                step(waiter, now))
+                break;
+
+            if (waiter.due - now < wait)
+                wait = waiter.due - now;
+            //Nobody can tell when an edge comes, look again soon
+            if (waiter.radio && waiter.radio->radio.isInterruptMode() &&
+                wait > RDA5807M_CORO_SLICE_US)
+                wait = RDA5807M_CORO_SLICE_US;
+        };
+
+        if (!*link)
+            return wait ? wait : 1;
+
+        //Unlink before resuming: the coroutine may wait again, and its
+        //waiter may well reuse the same frame memory
+        RDA5807MWaiter &waiter = **link;
+
+        *link = waiter.next;
+        stats.resumes++;
+        waiter.handle.resume();
+    };
+};
+
+void RDA5807MScheduler::run(void) {
+    unsigned long wait;
+
+    while ((wait = runOnce())) {
+        stats.sleeps++;
+        delayMicroseconds(wait);
+    };
+};
+
+#endif
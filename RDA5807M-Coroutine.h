@@ -0,0 +1,246 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the C++20 coroutine interface: awaitable tune,
+ * seek and RDS group reception on top of the tuning engine, and a single
+ * threaded scheduler that resumes them from timers or GPIO2 interrupts. It is
+ * only available on a host compiler with coroutine support (-std=c++20).
+ */
+
+#ifndef _RDA5807M_COROUTINE_H_INCLUDED
+#define _RDA5807M_COROUTINE_H_INCLUDED
+
+#include "RDA5807M.h"
+
+#if !defined(ARDUINO) && defined(__cpp_impl_coroutine)
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <new>
+
+//How often, in milliseconds, a polled radio waiting for RDS reads the chip:
+//about twice per RDS group, so none is missed.
+#define RDA5807M_CORO_RDS_POLL_MS 40
+//How long, in microseconds, the scheduler sleeps at a time while waiting for
+//an interrupt.
+#define RDA5807M_CORO_SLICE_US 1000UL
+
+//What awaiters wait for, see RDA5807MWaiter
+#define RDA5807M_WAIT_SLEEP 0x0
+#define RDA5807M_WAIT_TUNER 0x1
+#define RDA5807M_WAIT_RDS 0x2
+
+class RDA5807MAsync;
+class RDA5807MScheduler;
+
+//Scheduler work, see RDA5807MScheduler::getStats().
+typedef struct {
+    unsigned long resumes; //Coroutines resumed
+    unsigned long polls; //Chip reads on behalf of a waiting coroutine
+    unsigned long interrupts; //Wakeups by a GPIO2 edge
+    unsigned long sleeps; //Times the scheduler went idle
+} TRDA5807MSchedulerStats;
+
+/*
+ * Coroutine return type for code driving radios: it starts straight away,
+ * runs until its first co_await and frees itself when it returns. Frame
+ * memory in use is tracked in getFrameBytes().
+ */
+class RDA5807MTask
+{
+    public:
+        struct promise_type {
+            RDA5807MTask get_return_object(void) { return RDA5807MTask(); };
+            std::suspend_never initial_suspend(void) noexcept { return {}; };
+            std::suspend_never final_suspend(void) noexcept { return {}; };
+            void return_void(void) {};
+            void unhandled_exception(void) { std::terminate(); };
+
+            static void *operator new(size_t size) {
+                frameBytes += size;
+                if (frameBytes > peakFrameBytes)
+                    peakFrameBytes = frameBytes;
+
+                return ::operator new(size);
+            };
+            static void operator delete(void *frame, size_t size) {
+                frameBytes -= size;
+                ::operator delete(frame);
+            };
+        };
+
+        static unsigned long getFrameBytes(void) { return frameBytes; };
+        static unsigned long getPeakFrameBytes(void) { return peakFrameBytes; };
+
+    private:
+        static inline unsigned long frameBytes = 0, peakFrameBytes = 0;
+};
+
+/*
+ * One suspended coroutine, linked into the scheduler until what it waits for
+ * has happened. Lives in the coroutine frame, so waiting allocates nothing.
+ */
+class RDA5807MWaiter
+{
+    public:
+        RDA5807MWaiter(RDA5807MScheduler &scheduler, RDA5807MAsync *radio,
+                       byte kind, unsigned long delay) :
+            scheduler(scheduler), radio(radio), kind(kind), delay(delay),
+            state(RDA5807M_TUNER_IDLE) {};
+
+        //A seek or tune the driver refused is over before it began
+        bool await_ready(void) {
+            return kind == RDA5807M_WAIT_TUNER &&
+                state == RDA5807M_TUNER_FAILED;
+        };
+        void await_suspend(std::coroutine_handle<> handle);
+
+    protected:
+        friend class RDA5807MScheduler;
+        friend class RDA5807MAsync;
+
+        RDA5807MScheduler &scheduler;
+        RDA5807MAsync *radio;
+        byte kind;
+        unsigned long delay; //Microseconds until first due
+        unsigned long due;
+        std::coroutine_handle<> handle;
+        RDA5807MWaiter *next;
+        byte state; //Tuning engine state, for RDA5807M_WAIT_TUNER
+        TRDA5807MStatus status; //For RDA5807M_WAIT_RDS
+};
+
+//co_await scheduler.sleep(ms)
+class RDA5807MSleep : public RDA5807MWaiter
+{
+    public:
+        using RDA5807MWaiter::RDA5807MWaiter;
+        void await_resume(void) {};
+};
+
+//co_await radio.tune(f) and co_await radio.seek(up), yielding the final
+//tuning engine state: RDA5807M_TUNER_SETTLED or RDA5807M_TUNER_FAILED.
+class RDA5807MTuneWaiter : public RDA5807MWaiter
+{
+    public:
+        using RDA5807MWaiter::RDA5807MWaiter;
+        byte await_resume(void) { return state; };
+};
+
+//co_await radio.nextGroup(), yielding the status registers as read with
+//the new group in them.
+class RDA5807MGroupWaiter : public RDA5807MWaiter
+{
+    public:
+        using RDA5807MWaiter::RDA5807MWaiter;
+        const TRDA5807MStatus &await_resume(void) { return status; };
+};
+
+/*
+ * Runs suspended coroutines on the calling thread. A radio waiting for its
+ * tuning engine or for RDS is only read when due: on the driver's own polling
+ * schedule or, for radios in interrupt mode, after a GPIO2 edge reported with
+ * RDA5807MAsync::handleInterrupt(). In between, the thread sleeps (delay(),
+ * so simulated time works too).
+ */
+class RDA5807MScheduler
+{
+    public:
+        RDA5807MScheduler(void) : waiters(NULL) { clearStats(); };
+
+        /*
+        * Description:
+        *   Suspends the calling coroutine for the given time.
+        */
+        RDA5807MSleep sleep(unsigned long ms) {
+            return RDA5807MSleep(*this, NULL, RDA5807M_WAIT_SLEEP,
+                                 ms * 1000UL);
+        };
+
+        /*
+        * Description:
+        *   Resumes coroutines as what they wait for happens, until none is
+        *   left waiting.
+        */
+        void run(void);
+
+        /*
+        * Description:
+        *   Resumes every coroutine that is due now, without sleeping.
+        * Returns:
+        *   microseconds until the next one is due, 0 if nothing waits.
+        */
+        unsigned long runOnce(void);
+
+        const TRDA5807MSchedulerStats &getStats(void) { return stats; };
+        void clearStats(void) { memset(&stats, 0x00, sizeof(stats)); };
+
+    private:
+        friend class RDA5807MWaiter;
+
+        RDA5807MWaiter *waiters;
+        TRDA5807MSchedulerStats stats;
+
+        /*
+        * Description:
+        *   Checks on a due waiter. Returns true if it can be resumed.
+        */
+        bool step(RDA5807MWaiter &waiter, unsigned long now);
+};
+
+/*
+ * An RDA5807M driven from coroutines. Only one operation per radio may be
+ * awaited at a time.
+ */
+class RDA5807MAsync
+{
+    public:
+        RDA5807MAsync(RDA5807M &radio, RDA5807MScheduler &scheduler) :
+            radio(radio), scheduler(scheduler), irq(false) {};
+
+        /*
+        * Description:
+        *   Starts a tune or a seek, see RDA5807M::setFrequency() and
+        *   seekUp()/seekDown(), and suspends until the chip settles.
+        *   A frequency setFrequency() refuses completes at once as
+        *   RDA5807M_TUNER_FAILED.
+        */
+        RDA5807MTuneWaiter tune(word frequency);
+        RDA5807MTuneWaiter seek(bool up, bool wrap = true);
+
+        /*
+        * Description:
+        *   Suspends until the chip has a new RDS group. Awaited in a loop it
+        *   works as a generator of groups.
+        */
+        RDA5807MGroupWaiter nextGroup(void) {
+            return RDA5807MGroupWaiter(scheduler, this, RDA5807M_WAIT_RDS, 0);
+        };
+
+        /*
+        * Description:
+        *   Records a GPIO2 edge, for radios in interrupt mode. Safe to call
+        *   from a signal handler or another thread.
+        */
+        void handleInterrupt(void) { irq = true; };
+
+        RDA5807M &getRadio(void) { return radio; };
+
+    private:
+        friend class RDA5807MScheduler;
+
+        RDA5807M &radio;
+        RDA5807MScheduler &scheduler;
+        std::atomic<bool> irq;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file implements the Arduino core functions the library needs when
+ * built for a (POSIX) host. It compiles to nothing on Arduino.
+ */
+
+#if !defined(ARDUINO)
+
+#include "RDA5807M-Host.h"
+
+#include <time.h>
+
+static unsigned long monotonicMicros(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long)now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+};
+
+static void monotonicSleep(unsigned long us) {
+    struct timespec duration;
+
+    duration.tv_sec = us / 1000000UL;
+    duration.tv_nsec = (us % 1000000UL) * 1000;
+    while (nanosleep(&duration, &duration))
+        ;
+};
+
+unsigned long (*RDA5807MHostMicros)(void) = monotonicMicros;
+void (*RDA5807MHostSleep)(unsigned long us) = monotonicSleep;
+
+unsigned long millis(void) {
+    return RDA5807MHostMicros() / 1000;
+};
+
+unsigned long micros(void) {
+    return RDA5807MHostMicros();
+};
+
+void delay(unsigned long ms) {
+    RDA5807MHostSleep(ms * 1000);
+};
+
+void delayMicroseconds(unsigned int us) {
+    RDA5807MHostSleep(us);
+};
+
+#endif
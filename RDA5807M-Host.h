@@ -0,0 +1,46 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file provides the handful of Arduino core definitions the library
+ * relies on when built for a (POSIX) host instead of an Arduino board.
+ */
+
+#ifndef _RDA5807M_HOST_H_INCLUDED
+#define _RDA5807M_HOST_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef uint16_t word;
+
+inline word makeWord(word w) { return w; };
+inline word makeWord(byte h, byte l) { return ((word)h << 8) | l; };
+
+#define word(...) makeWord(__VA_ARGS__)
+#define highByte(w) ((byte)((w) >> 8))
+#define lowByte(w) ((byte)((w) & 0xFF))
+
+//No separate program memory on the host
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const byte *)(addr))
+#define pgm_read_word(addr) (*(const word *)(addr))
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+//Clock used by the functions above, a monotonic wall clock by default. Can be
+//pointed elsewhere, e.g. at simulated time.
+extern unsigned long (*RDA5807MHostMicros)(void);
+extern void (*RDA5807MHostSleep)(unsigned long us);
+
+#endif
@@ -0,0 +1,101 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the optional bus instrumentation. It compiles to
+ * nothing unless RDA5807M_INSTRUMENTATION is defined.
+ * See the header file for better function documentation.
+ */
+
+#include "RDA5807M.h"
+
+#if defined(RDA5807M_INSTRUMENTATION)
+
+#include <string.h>
+
+//Operation names in RDA5807M_OP_* order, each one NUL-terminated
+static const char RDA5807M_OpNames[] PROGMEM =
+    "(none)\0begin\0end\0setRegister\0getRegister\0getShadowRegister\0"
+    "updateRegister\0resync\0commit\0setRegisterBulk\0getRegisterBulk\0"
+    "volumeUp\0volumeDown\0seekUp\0seekDown\0mute\0unMute\0getFrequency\0"
+    "setFrequency\0getRSSI\0isStereo\0getStatus\0tick\0enableInterrupts\0"
+    "disableInterrupts\0scan\0standby\0resume\0setBand\0setDirectFrequency\0"
+    "setI2S\0readRDSGroup\0setTuning";
+
+TRDA5807MOpStats RDA5807MInstrumentation::stats[RDA5807M_OP_COUNT];
+byte RDA5807MInstrumentation::current = RDA5807M_OP_NONE;
+
+static void saturatingIncrement(word &counter) {
+    if (counter != 0xFFFF)
+        counter++;
+};
+
+static void saturatingAdd(unsigned long &counter, unsigned long value) {
+    counter = counter + value < counter ? 0xFFFFFFFFUL : counter + value;
+};
+
+void RDA5807MInstrumentation::clear(void) {
+    memset(stats, 0x00, sizeof(stats));
+};
+
+byte RDA5807MInstrumentation::getName(byte op, char *buffer, byte size) {
+    const char *name = RDA5807M_OpNames;
+    byte length = 0;
+
+    //Skip to the op-th name
+    for(; op && op < RDA5807M_OP_COUNT; name++)
+        if (!pgm_read_byte(name))
+            op--;
+
+    for(char c; length + 1 < size && (c = pgm_read_byte(name)); name++)
+        buffer[length++] = c;
+    if (size)
+        buffer[length] = '\0';
+
+    return length;
+};
+
+byte RDA5807MInstrumentation::getBucket(unsigned long elapsed) {
+    byte bucket = 0;
+
+    for(unsigned long limit = RDA5807M_HISTOGRAM_BASE;
+        bucket < RDA5807M_HISTOGRAM_BUCKETS - 1 && elapsed >= limit;
+        limit <<= 1)
+        bucket++;
+
+    return bucket;
+};
+
+bool RDA5807MInstrumentation::enter(byte op) {
+    if (current != RDA5807M_OP_NONE)
+        return false;
+
+    current = op;
+    saturatingIncrement(stats[op].calls);
+
+    return true;
+};
+
+void RDA5807MInstrumentation::leave(unsigned long elapsed) {
+    saturatingAdd(stats[current].micros, elapsed);
+    saturatingIncrement(stats[current].histogram[getBucket(elapsed)]);
+    current = RDA5807M_OP_NONE;
+};
+
+void RDA5807MInstrumentation::count(byte bytes, bool nack) {
+    TRDA5807MOpStats &op = stats[current];
+
+    if (bytes) {
+        saturatingAdd(op.transactions, 1);
+        saturatingAdd(op.bytes, bytes);
+    };
+    if (nack)
+        saturatingIncrement(op.nacks);
+};
+
+#endif
@@ -0,0 +1,204 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the optional bus instrumentation, enabled by
+ * defining RDA5807M_INSTRUMENTATION when building the library. When it isn't
+ * defined, none of this is compiled and RDA5807M_OP() expands to nothing.
+ */
+
+#ifndef _RDA5807M_INSTRUMENTATION_H_INCLUDED
+#define _RDA5807M_INSTRUMENTATION_H_INCLUDED
+
+#if defined(RDA5807M_INSTRUMENTATION)
+
+//Public operations statistics are kept for. Bus traffic is charged to the
+//outermost one in progress, e.g. the getRegister() calls made by
+//setFrequency() count towards setFrequency(). RDA5807M_OP_NONE collects
+//traffic issued outside any of them.
+#define RDA5807M_OP_NONE 0
+#define RDA5807M_OP_BEGIN 1
+#define RDA5807M_OP_END 2
+#define RDA5807M_OP_SETREGISTER 3
+#define RDA5807M_OP_GETREGISTER 4
+#define RDA5807M_OP_GETSHADOWREGISTER 5
+#define RDA5807M_OP_UPDATEREGISTER 6
+#define RDA5807M_OP_RESYNC 7
+#define RDA5807M_OP_COMMIT 8
+#define RDA5807M_OP_SETREGISTERBULK 9
+#define RDA5807M_OP_GETREGISTERBULK 10
+#define RDA5807M_OP_VOLUMEUP 11
+#define RDA5807M_OP_VOLUMEDOWN 12
+#define RDA5807M_OP_SEEKUP 13
+#define RDA5807M_OP_SEEKDOWN 14
+#define RDA5807M_OP_MUTE 15
+#define RDA5807M_OP_UNMUTE 16
+#define RDA5807M_OP_GETFREQUENCY 17
+#define RDA5807M_OP_SETFREQUENCY 18
+#define RDA5807M_OP_GETRSSI 19
+#define RDA5807M_OP_ISSTEREO 20
+#define RDA5807M_OP_GETSTATUS 21
+#define RDA5807M_OP_TICK 22
+#define RDA5807M_OP_ENABLEINTERRUPTS 23
+#define RDA5807M_OP_DISABLEINTERRUPTS 24
+#define RDA5807M_OP_SCAN 25
+#define RDA5807M_OP_STANDBY 26
+#define RDA5807M_OP_RESUME 27
+#define RDA5807M_OP_SETBAND 28
+#define RDA5807M_OP_SETDIRECTFREQUENCY 29
+#define RDA5807M_OP_SETI2S 30
+#define RDA5807M_OP_READRDSGROUP 31
+#define RDA5807M_OP_SETTUNING 32
+#define RDA5807M_OP_COUNT 33
+
+//Latency histogram: bucket 0 holds operations that took less than
+//RDA5807M_HISTOGRAM_BASE microseconds, each following one twice as long a
+//range and the last one everything above. Define either before including
+//this file to trade resolution for RAM.
+#if !defined(RDA5807M_HISTOGRAM_BUCKETS)
+# define RDA5807M_HISTOGRAM_BUCKETS 8
+#endif
+#if !defined(RDA5807M_HISTOGRAM_BASE)
+# define RDA5807M_HISTOGRAM_BASE 128
+#endif
+
+//Statistics for one operation. Counters stop at their maximum rather than
+//wrap around.
+typedef struct {
+    word calls;
+    word nacks;
+    unsigned long transactions; //One per I2C message, i.e. per address byte
+    unsigned long bytes; //Address bytes included
+    unsigned long micros; //Total time spent in the operation
+    word histogram[RDA5807M_HISTOGRAM_BUCKETS];
+} TRDA5807MOpStats;
+
+class RDA5807MInstrumentation
+{
+    public:
+        /*
+        * Description:
+        *   Returns the statistics gathered for the given operation.
+        * Parameters:
+        *   op - one of the RDA5807M_OP_* constants.
+        */
+        static const TRDA5807MOpStats &getStats(byte op) { return stats[op]; };
+
+        /*
+        * Description:
+        *   Zeroes all statistics.
+        */
+        static void clear(void);
+
+        /*
+        * Description:
+        *   Copies the name of the given operation (e.g. "setFrequency") into
+        *   buffer, truncating it to fit.
+        * Parameters:
+        *   op     - one of the RDA5807M_OP_* constants.
+        *   buffer - where to store the name.
+        *   size   - size of buffer, including the terminating NUL.
+        * Returns:
+        *   length of the name stored.
+        */
+        static byte getName(byte op, char *buffer, byte size);
+
+        /*
+        * Description:
+        *   Returns the histogram bucket an operation taking the given number
+        *   of microseconds falls into.
+        */
+        static byte getBucket(unsigned long elapsed);
+
+        /*
+        * Description:
+        *   Used by the driver to mark the start and end of an operation.
+        *   enter() returns true if op is now the outermost operation, in
+        *   which case leave() must be called when it completes.
+        */
+        static bool enter(byte op);
+        static void leave(unsigned long elapsed);
+
+        /*
+        * Description:
+        *   Used by the bus wrapper to charge one I2C message of the given
+        *   size (address byte included) to the current operation.
+        */
+        static void count(byte bytes, bool nack);
+
+    private:
+        static TRDA5807MOpStats stats[RDA5807M_OP_COUNT];
+        static byte current;
+};
+
+//Marks the lifetime of one operation, see RDA5807M_OP().
+class RDA5807MOpScope
+{
+    public:
+        RDA5807MOpScope(byte op) : outer(RDA5807MInstrumentation::enter(op)),
+                                   start(outer ? micros() : 0) {};
+        ~RDA5807MOpScope() {
+            if (outer)
+                RDA5807MInstrumentation::leave(micros() - start);
+        };
+
+    private:
+        bool outer;
+        unsigned long start;
+};
+
+/*
+ * Wraps whichever bus backend was selected, counting every message that goes
+ * through it. Methods hide rather than override the backend's, which the
+ * driver holds by value, so there is still no virtual dispatch.
+ */
+class RDA5807MInstrumentedBus : public RDA5807MBus
+{
+    public:
+        void beginTransmission(byte address) {
+            RDA5807MBus::beginTransmission(address);
+            pending = 1;
+        };
+        void write(byte value) {
+            RDA5807MBus::write(value);
+            pending++;
+        };
+        byte endTransmission(bool stop) {
+            const byte result = RDA5807MBus::endTransmission(stop);
+
+            RDA5807MInstrumentation::count(pending, result != 0);
+
+            return result;
+        };
+        byte requestFrom(byte address, byte count, bool stop) {
+            const byte result = RDA5807MBus::requestFrom(address, count, stop);
+
+            RDA5807MInstrumentation::count(1 + result, result != count);
+
+            return result;
+        };
+        byte endMessageSet(void) {
+            const byte result = RDA5807MBus::endMessageSet();
+
+            //Backends that hold messages back only find out about NACKs here
+            if (result)
+                RDA5807MInstrumentation::count(0, true);
+
+            return result;
+        };
+
+    private:
+        byte pending;
+};
+
+# define RDA5807M_OP(id) RDA5807MOpScope rda5807mOpScope(RDA5807M_OP_##id)
+#else
+# define RDA5807M_OP(id)
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the Linux i2c-dev bus backend. It compiles to
+ * nothing unless RDA5807M_BUS_LINUX is defined.
+ * See the header file for better function documentation.
+ */
+
+#if defined(RDA5807M_BUS_LINUX)
+
+#include "RDA5807M.h"
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+bool RDA5807MBus::open(const char *device) {
+    close();
+    fd = ::open(device, O_RDWR);
+
+    return fd >= 0;
+};
+
+void RDA5807MBus::close(void) {
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+};
+
+void RDA5807MBus::beginTransmission(byte address) {
+    //Out of room, send what we have and start over
+    if (messages == RDA5807M_LINUX_MESSAGES)
+        flush();
+
+    msgs[messages].addr = address;
+    msgs[messages].flags = 0;
+    msgs[messages].len = 0;
+    msgs[messages].buf = &txBuffer[used];
+};
+
+void RDA5807MBus::write(byte value) {
+    if (used < RDA5807M_LINUX_BUFFER) {
+        txBuffer[used++] = value;
+        msgs[messages].len++;
+    };
+};
+
+byte RDA5807MBus::endTransmission(bool stop) {
+    messages++;
+
+    //Held for a repeated start into the following read, or for the rest of
+    //the message set
+    if (!stop || grouping)
+        return 0;
+
+    return flush();
+};
+
+byte RDA5807MBus::requestFrom(byte address, byte count, bool) {
+    if (messages == RDA5807M_LINUX_MESSAGES)
+        flush();
+    if (count > sizeof(rxBuffer))
+        count = sizeof(rxBuffer);
+
+    msgs[messages].addr = address;
+    msgs[messages].flags = I2C_M_RD;
+    msgs[messages].len = count;
+    msgs[messages].buf = rxBuffer;
+    messages++;
+    received = 0;
+
+    //Reads always go out at once, so they always end with a stop
+    available = flush() ? 0 : count;
+
+    return available;
+};
+
+byte RDA5807MBus::flush(void) {
+    if (!messages)
+        return 0;
+
+    struct i2c_rdwr_ioctl_data data;
+    int result;
+
+    data.msgs = msgs;
+    data.nmsgs = messages;
+    syscalls++;
+    if (transfer)
+        result = transfer(context, msgs, messages);
+    else
+        result = ioctl(fd, I2C_RDWR, &data);
+    messages = 0;
+    used = 0;
+
+    return result < 0 ? 4 : 0;
+};
+
+#endif
@@ -0,0 +1,120 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file contains the Linux i2c-dev bus backend, selected by defining
+ * RDA5807M_BUS_LINUX at compile time.
+ */
+
+#ifndef _RDA5807M_LINUX_H_INCLUDED
+#define _RDA5807M_LINUX_H_INCLUDED
+
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+//Bytes and messages a single I2C_RDWR call can carry. The largest transaction
+//the driver issues is a sequential write of the whole register file.
+#define RDA5807M_LINUX_BUFFER 128
+#define RDA5807M_LINUX_MESSAGES 16
+
+//Replacement for the I2C_RDWR ioctl, e.g. a fake device for benchmarking.
+//Returns a negative value on failure, like ioctl() does.
+typedef int (*TRDA5807MLinuxTransfer)(void *context, struct i2c_msg msgs[],
+                                      int count);
+
+/*
+ * Same interface as the Wire backend (see RDA5807M-Wire.h). Transactions are
+ * queued as i2c_msg entries and submitted with a single I2C_RDWR ioctl, so a
+ * register read (address write, repeated start, data read) is one syscall
+ * that holds the bus throughout, instead of separate write() and read()
+ * calls. The device file stays open for the lifetime of the object.
+ */
+class RDA5807MBus
+{
+    public:
+        RDA5807MBus(void) : fd(-1), transfer(NULL), context(NULL),
+                            grouping(false), messages(0), used(0),
+                            available(0), received(0), syscalls(0) {};
+        ~RDA5807MBus() { close(); };
+
+        /*
+        * Description:
+        *   Opens the given i2c-dev device, e.g. "/dev/i2c-1".
+        * Returns:
+        *   true on success, false otherwise (errno tells why).
+        */
+        bool open(const char *device);
+
+        /*
+        * Description:
+        *   Closes the device, if open.
+        */
+        void close(void);
+
+        /*
+        * Description:
+        *   Routes transactions to the given function instead of the device.
+        * Parameters:
+        *   transfer - replacement for the I2C_RDWR ioctl, NULL to restore.
+        *   context  - passed through to transfer untouched.
+        */
+        void setTransfer(TRDA5807MLinuxTransfer transfer, void *context) {
+            this->transfer = transfer;
+            this->context = context;
+        };
+
+        /*
+        * Description:
+        *   Returns the number of I2C_RDWR calls issued so far.
+        */
+        unsigned long getSyscalls(void) { return syscalls; };
+
+        /*
+        * Description:
+        *   Between these two calls completed write transactions are held
+        *   back and submitted together in one I2C_RDWR call. Errors are only
+        *   reported by endMessageSet().
+        */
+        void beginMessageSet(void) { grouping = true; };
+        byte endMessageSet(void) {
+            grouping = false;
+
+            return flush();
+        };
+
+        void begin(void) {};
+        void beginTransmission(byte address);
+        void write(byte value);
+        byte endTransmission(bool stop);
+        byte requestFrom(byte address, byte count, bool stop);
+        byte read(void) {
+            return received < available ? rxBuffer[received++] : 0xFF;
+        };
+
+    private:
+        int fd;
+        TRDA5807MLinuxTransfer transfer;
+        void *context;
+        bool grouping;
+        struct i2c_msg msgs[RDA5807M_LINUX_MESSAGES];
+        byte messages;
+        byte txBuffer[RDA5807M_LINUX_BUFFER];
+        byte rxBuffer[RDA5807M_LINUX_BUFFER];
+        byte used, available, received;
+        unsigned long syscalls;
+
+        /*
+        * Description:
+        *   Submits all queued messages in a single I2C_RDWR call.
+        * Returns:
+        *   0 on success, 4 (TwoWire's "other error") otherwise.
+        */
+        byte flush(void);
+};
+
+#endif
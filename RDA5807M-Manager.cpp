@@ -0,0 +1,314 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the multi-receiver manager. It compiles to
+ * nothing on Arduino.
+ * See the header file for better function documentation.
+ */
+
+#if !defined(ARDUINO)
+
+#include "RDA5807M-Manager.h"
+#include "RDA5807M-private.h"
+
+//Jobs for the workers
+#define MANAGER_BEGIN 0
+#define MANAGER_END 1
+#define MANAGER_TUNE 2
+#define MANAGER_SAMPLE 3
+#define MANAGER_TASK 4
+
+//Multiplexer state nobody knows yet
+#define MANAGER_MUX_UNKNOWN 0xFF
+
+RDA5807MManager::RDA5807MManager(void) : count(0), generation(0), pending(0),
+                                         quit(false) {
+    for(byte i=0; i < RDA5807M_MANAGER_BUSES; i++) {
+        buses[i].count = 0;
+        buses[i].muxAddress = MANAGER_MUX_UNKNOWN;
+        buses[i].lastSample = 0;
+    };
+    clearStats();
+};
+
+RDA5807MManager::~RDA5807MManager() {
+    if (count)
+        end();
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    };
+    wake.notify_all();
+    for(byte i=0; i < RDA5807M_MANAGER_BUSES; i++)
+        if (buses[i].worker.joinable())
+            buses[i].worker.join();
+};
+
+int RDA5807MManager::add(byte bus, byte muxAddress, byte muxChannel) {
+    if (count == RDA5807M_MANAGER_RADIOS || bus >= RDA5807M_MANAGER_BUSES)
+        return -1;
+
+    TBus &target = buses[bus];
+    const word key = word(muxAddress, muxChannel);
+    byte position = target.count;
+
+    radios[count].bus = bus;
+    radios[count].muxAddress = muxAddress;
+    radios[count].muxChannel = muxChannel;
+    //Keep the bus' visiting order sorted by multiplexer and channel
+    while (position && word(radios[target.order[position - 1]].muxAddress,
+                            radios[target.order[position - 1]].muxChannel) >
+           key) {
+        target.order[position] = target.order[position - 1];
+        position--;
+    };
+    target.order[position] = count;
+    target.count++;
+    //Whatever the new chip's multiplexer has open is anybody's guess
+    if (muxAddress != RDA5807M_MUX_NONE)
+        target.muxAddress = MANAGER_MUX_UNKNOWN;
+
+    return count++;
+};
+
+void RDA5807MManager::begin(byte band) {
+    this->band = band;
+    dispatch(MANAGER_BEGIN);
+};
+
+void RDA5807MManager::end(void) {
+    dispatch(MANAGER_END);
+};
+
+byte RDA5807MManager::tune(const word frequencies[]) {
+    byte settled = 0;
+
+    this->frequencies = frequencies;
+    dispatch(MANAGER_TUNE);
+    for(byte i=0; i < RDA5807M_MANAGER_BUSES; i++)
+        settled += buses[i].settled;
+
+    return settled;
+};
+
+void RDA5807MManager::sample(TRDA5807MSample samples[], word period) {
+    this->samples = samples;
+    this->period = period;
+    dispatch(MANAGER_SAMPLE);
+};
+
+void RDA5807MManager::forEach(TRDA5807MManagerTask task, void *context) {
+    this->task = task;
+    this->context = context;
+    dispatch(MANAGER_TASK);
+};
+
+TRDA5807MManagerStats RDA5807MManager::getStats(void) {
+    TRDA5807MManagerStats stats = totals;
+
+    for(byte i=0; i < RDA5807M_MANAGER_BUSES; i++) {
+        stats.visits += buses[i].stats.visits;
+        stats.muxWrites += buses[i].stats.muxWrites;
+        stats.rdsGroups += buses[i].stats.rdsGroups;
+    };
+
+    return stats;
+};
+
+void RDA5807MManager::clearStats(void) {
+    memset(&totals, 0x00, sizeof(totals));
+    for(byte i=0; i < RDA5807M_MANAGER_BUSES; i++)
+        memset(&buses[i].stats, 0x00, sizeof(buses[i].stats));
+};
+
+void RDA5807MManager::dispatch(byte job) {
+    std::unique_lock<std::mutex> guard(lock);
+    unsigned long slowest = 0;
+
+    this->job = job;
+    pending = 0;
+    for(byte i=0; i < RDA5807M_MANAGER_BUSES; i++)
+        if (buses[i].count) {
+            //Workers start on their bus' first job
+            if (!buses[i].worker.joinable())
+                buses[i].worker = std::thread(&RDA5807MManager::work, this, i);
+            pending++;
+        };
+    generation++;
+    wake.notify_all();
+    while (pending)
+        done.wait(guard);
+
+    for(byte i=0; i < RDA5807M_MANAGER_BUSES; i++)
+        if (buses[i].count && buses[i].busy > slowest)
+            slowest = buses[i].busy;
+    totals.sweeps++;
+    totals.micros += slowest;
+};
+
+void RDA5807MManager::work(byte bus) {
+    std::unique_lock<std::mutex> guard(lock);
+    //A worker started by dispatch() has that job to do straight away
+    unsigned long seen = generation - 1;
+
+    for(;;) {
+        while (!quit && generation == seen)
+            wake.wait(guard);
+        if (quit)
+            return;
+        seen = generation;
+
+        guard.unlock();
+        run(buses[bus]);
+        guard.lock();
+
+        if (!--pending)
+            done.notify_one();
+    };
+};
+
+void RDA5807MManager::run(TBus &bus) {
+    unsigned long start = micros();
+
+    switch (job) {
+        case MANAGER_BEGIN:
+        case MANAGER_END:
+        case MANAGER_TASK:
+            for(byte i=0; i < bus.count; i++) {
+                const byte index = bus.order[i];
+
+                select(bus, index);
+                if (job == MANAGER_BEGIN)
+                    radios[index].radio.begin(band);
+                else if (job == MANAGER_END)
+                    radios[index].radio.end();
+                else
+                    task(radios[index].radio, index, context);
+                bus.stats.visits++;
+            };
+            break;
+        case MANAGER_TUNE: {
+            byte tuning = 0;
+
+            bus.settled = 0;
+            //Start every tune first so they all settle at the same time...
+            for(byte i=0; i < bus.count; i++) {
+                const byte index = bus.order[i];
+
+                if (!frequencies[index])
+                    continue;
+                select(bus, index);
+                if (radios[index].radio.setFrequency(frequencies[index]))
+                    tuning++;
+                bus.stats.visits++;
+            };
+            //...then go round collecting them, which only switches channels
+            //when there's a chance of finding somebody done
+            if (tuning)
+                delay(RDA5807M_TUNE_SETTLE_MS);
+            while (tuning) {
+                tuning = 0;
+                for(byte i=0; i < bus.count; i++) {
+                    const byte index = bus.order[i];
+                    RDA5807M &radio = radios[index].radio;
+
+                    if (!frequencies[index] ||
+                        radio.getTunerState() != RDA5807M_TUNER_TUNING)
+                        continue;
+                    select(bus, index);
+                    switch (radio.poll()) {
+                        case RDA5807M_TUNER_SETTLED:
+                            bus.settled++;
+                            //Fall through
+                        case RDA5807M_TUNER_FAILED:
+                            break;
+                        default:
+                            tuning++;
+                    };
+                    bus.stats.visits++;
+                };
+                if (tuning)
+                    delay(RDA5807M_TUNE_POLL_MS);
+            };
+            break;
+        };
+        case MANAGER_SAMPLE:
+            //Pacing isn't work
+            if (period && start - bus.lastSample < period * 1000UL)
+                delay(period - (start - bus.lastSample) / 1000);
+            start = bus.lastSample = micros();
+            for(byte i=0; i < bus.count; i++) {
+                const byte index = bus.order[i];
+                RDA5807M &radio = radios[index].radio;
+                TRDA5807MSample &sample = samples[index];
+
+                select(bus, index);
+                sample.status = radio.getStatus();
+                sample.rssi = (sample.status.rssi & RDA5807M_RSSI_MASK) >>
+                    RDA5807M_RSSI_SHIFT;
+                sample.stereo = radio.isStereo(sample.status);
+                sample.rds = sample.status.status & RDA5807M_STATUS_RDSR;
+                sample.time = micros();
+                if (sample.rds)
+                    bus.stats.rdsGroups++;
+                bus.stats.visits++;
+            };
+            break;
+    };
+
+    bus.busy = micros() - start;
+    bus.stats.sweeps++;
+    bus.stats.micros += bus.busy;
+};
+
+void RDA5807MManager::select(TBus &bus, byte index) {
+    const TRadio &radio = radios[index];
+
+    if (bus.muxAddress == radio.muxAddress &&
+        (radio.muxAddress == RDA5807M_MUX_NONE ||
+         bus.muxChannel == radio.muxChannel))
+        return;
+
+    if (bus.muxAddress == MANAGER_MUX_UNKNOWN) {
+        //Close every multiplexer on the bus, each through a radio behind it
+        for(byte i=0; i < bus.count; i++) {
+            const TRadio &other = radios[bus.order[i]];
+
+            if (other.muxAddress != RDA5807M_MUX_NONE &&
+                (!i || radios[bus.order[i - 1]].muxAddress !=
+                 other.muxAddress)) {
+                writeMux(bus.order[i], other.muxAddress, 0x00);
+                bus.stats.muxWrites++;
+            };
+        };
+    } else if (bus.muxAddress != RDA5807M_MUX_NONE &&
+               bus.muxAddress != radio.muxAddress) {
+        writeMux(bus.muxRadio, bus.muxAddress, 0x00);
+        bus.stats.muxWrites++;
+    };
+
+    if (radio.muxAddress != RDA5807M_MUX_NONE) {
+        writeMux(index, radio.muxAddress, 1 << radio.muxChannel);
+        bus.stats.muxWrites++;
+    };
+    bus.muxAddress = radio.muxAddress;
+    bus.muxChannel = radio.muxChannel;
+    bus.muxRadio = index;
+};
+
+void RDA5807MManager::writeMux(byte index, byte address, byte channels) {
+    RDA5807MBus &wire = radios[index].radio.getBus();
+
+    wire.beginTransmission(address);
+    wire.write(channels);
+    wire.endTransmission(true);
+};
+
+#endif
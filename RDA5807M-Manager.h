@@ -0,0 +1,223 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the multi-receiver manager, which runs many
+ * chips spread over several I2C buses and behind I2C multiplexers. It needs
+ * threads and is only available on a host (ARDUINO not defined).
+ */
+
+#ifndef _RDA5807M_MANAGER_H_INCLUDED
+#define _RDA5807M_MANAGER_H_INCLUDED
+
+#include "RDA5807M.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//Capacities
+#define RDA5807M_MANAGER_RADIOS 64
+#define RDA5807M_MANAGER_BUSES 8
+
+//Multiplexer addresses: TCA9548A and compatibles sit at 0x70 to 0x77.
+//RDA5807M_MUX_NONE is for chips wired straight to the bus.
+#define RDA5807M_MUX_ADDRESS 0x70
+#define RDA5807M_MUX_NONE 0x00
+
+//One sample of a managed radio, see RDA5807MManager::sample().
+typedef struct {
+    TRDA5807MStatus status; //As returned by RDA5807M::getStatus()
+    byte rssi;
+    bool stereo;
+    bool rds; //A new RDS group is in status.rds
+    unsigned long time; //In micros() of the bus worker
+} TRDA5807MSample;
+
+//Work done by the manager, in total or for one bus.
+typedef struct {
+    unsigned long sweeps; //Passes over every radio
+    unsigned long visits; //Operations on a single radio
+    unsigned long muxWrites; //Multiplexer channel switches
+    unsigned long rdsGroups; //Samples that brought a new RDS group
+    //Time spent sweeping; in total, that of the slowest bus in each sweep
+    unsigned long micros;
+} TRDA5807MManagerStats;
+
+//Function run on every radio by RDA5807MManager::forEach().
+typedef void (*TRDA5807MManagerTask)(RDA5807M &radio, byte index,
+                                     void *context);
+
+/*
+ * Owns up to RDA5807M_MANAGER_RADIOS RDA5807M instances, each one on a
+ * physical bus and possibly behind a multiplexer channel. Every operation
+ * runs on all radios at once, with one worker thread per physical bus, and
+ * returns when all buses are done. On each bus the radios are visited in
+ * multiplexer and channel order, so a multiplexer is only switched once per
+ * channel per sweep rather than once per radio.
+ *
+ * All chips answer to the same addresses, so only one multiplexer channel on
+ * a bus may be open at a time: the previous one is closed before another
+ * multiplexer is switched. Multiplexers are driven through the bus of the
+ * radio being visited, so the bus backend of every radio must already be set
+ * up (e.g. RDA5807MBus::open() or attach()) on the bus it was added with.
+ *
+ * The manager's methods must all be called from the same thread. With the
+ * simulator backend, each worker runs its chips in its own simulated time.
+ * RDA5807M_INSTRUMENTATION keeps its statistics in globals and can't be used
+ * together with the manager.
+ */
+class RDA5807MManager
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, it starts with no radios and no workers.
+        */
+        RDA5807MManager(void);
+
+        /*
+        * Description:
+        *   This is the destructor, it turns every radio off and stops the
+        *   workers.
+        */
+        ~RDA5807MManager();
+
+        /*
+        * Description:
+        *   Adds a radio.
+        * Parameters:
+        *   bus        - physical bus, 0 to RDA5807M_MANAGER_BUSES - 1.
+        *   muxAddress - address of the multiplexer in front of the chip or
+        *                RDA5807M_MUX_NONE.
+        *   muxChannel - the multiplexer's channel the chip is on, 0 to 7.
+        * Returns:
+        *   the radio's index or -1 if full.
+        */
+        int add(byte bus, byte muxAddress = RDA5807M_MUX_NONE,
+                byte muxChannel = 0);
+
+        byte getCount(void) { return count; };
+        RDA5807M &getRadio(byte index) { return radios[index].radio; };
+
+        /*
+        * Description:
+        *   Calls RDA5807M::begin() on every radio.
+        */
+        void begin(byte band);
+
+        /*
+        * Description:
+        *   Calls RDA5807M::end() on every radio.
+        */
+        void end(void);
+
+        /*
+        * Description:
+        *   Tunes every radio, all of them at once, and waits for them to
+        *   settle.
+        * Parameters:
+        *   frequencies - one per radio in 10kHz units, 0 to leave a radio
+        *                 alone.
+        * Returns:
+        *   number of radios that settled.
+        */
+        byte tune(const word frequencies[]);
+
+        /*
+        * Description:
+        *   Reads the status registers of every radio.
+        * Parameters:
+        *   samples - one per radio.
+        *   period  - minimum time, in milliseconds, since the previous sample
+        *             of the same bus. Workers wait on their own clock, so this
+        *             also paces simulated buses.
+        */
+        void sample(TRDA5807MSample samples[], word period = 0);
+
+        /*
+        * Description:
+        *   Runs task on every radio, with its multiplexer channel selected.
+        *   Tasks for radios on different buses run concurrently.
+        */
+        void forEach(TRDA5807MManagerTask task, void *context);
+
+        /*
+        * Description:
+        *   Work done so far, in total or for one bus.
+        */
+        TRDA5807MManagerStats getStats(void);
+        const TRDA5807MManagerStats &getStats(byte bus) {
+            return buses[bus].stats;
+        };
+        void clearStats(void);
+
+    private:
+        typedef struct {
+            RDA5807M radio;
+            byte bus;
+            byte muxAddress;
+            byte muxChannel;
+        } TRadio;
+
+        typedef struct {
+            std::thread worker;
+            byte count;
+            byte order[RDA5807M_MANAGER_RADIOS]; //Radios by mux and channel
+            byte muxAddress; //What's open now, 0xFF if unknown
+            byte muxChannel;
+            byte muxRadio; //Radio to reach muxAddress through
+            unsigned long lastSample;
+            byte settled;
+            unsigned long busy; //Time spent on the last job
+            TRDA5807MManagerStats stats;
+        } TBus;
+
+        TRadio radios[RDA5807M_MANAGER_RADIOS];
+        byte count;
+        TBus buses[RDA5807M_MANAGER_BUSES];
+        TRDA5807MManagerStats totals;
+
+        //Job for the workers, and its parameters
+        std::mutex lock;
+        std::condition_variable wake, done;
+        unsigned long generation;
+        byte pending;
+        bool quit;
+        byte job;
+        byte band;
+        const word *frequencies;
+        TRDA5807MSample *samples;
+        word period;
+        TRDA5807MManagerTask task;
+        void *context;
+
+        /*
+        * Description:
+        *   Hands the job set up in the members above to every worker, and
+        *   waits for all of them to finish.
+        */
+        void dispatch(byte job);
+
+        /*
+        * Description:
+        *   Worker thread for one bus.
+        */
+        void work(byte bus);
+        void run(TBus &bus);
+
+        /*
+        * Description:
+        *   Opens the multiplexer channel of the given radio, closing
+        *   whatever else was open on its bus.
+        */
+        void select(TBus &bus, byte index);
+        void writeMux(byte index, byte address, byte channels);
+};
+
+#endif
@@ -0,0 +1,279 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the preset bank.
+ * See the header file for better function documentation.
+ */
+
+#include "RDA5807M-Presets.h"
+
+#if defined(__AVR__)
+# include <EEPROM.h>
+#elif !defined(ARDUINO)
+# include <stdio.h>
+#endif
+
+void RDA5807MPresets::clear(void) {
+    memset(presets, 0x00, sizeof(presets));
+};
+
+bool RDA5807MPresets::set(byte slot, word frequency, byte band, byte space,
+                          bool east50M) {
+    band &= RDA5807M_BAND_MASK;
+    space &= RDA5807M_SPACE_MASK;
+    east50M = east50M && band == RDA5807M_BAND_EAST;
+
+    const word channel = RDA5807MFrequencyChannel(
+        RDA5807MBandIndex(band, east50M ? 0x00 : RDA5807M_FLG_EASTBAND65M),
+        space, frequency);
+
+    if (channel == RDA5807M_CHANNEL_INVALID)
+        return false;
+
+    clear(slot);
+    presets[slot].tuning = (channel << RDA5807M_CHAN_SHIFT) | band | space;
+    presets[slot].flags = RDA5807M_PRESET_USED |
+        (east50M ? RDA5807M_PRESET_EAST50M : 0x00);
+
+    return true;
+};
+
+bool RDA5807MPresets::store(byte slot, RDA5807M &radio) {
+    const word tuning = radio.getShadowRegister(RDA5807M_REG_TUNING);
+    const word blend = radio.getShadowRegister(RDA5807M_REG_BLEND);
+
+    if (blend & RDA5807M_FLG_FREQMODE)
+        return false;
+
+    //CHAN in the shadow copy is whatever was last written, not where a seek
+    //ended up
+    const TRDA5807MStatus &status = radio.getStatus();
+
+    clear(slot);
+    presets[slot].tuning = (tuning & (RDA5807M_BAND_MASK |
+                                      RDA5807M_SPACE_MASK)) |
+        ((status.status & RDA5807M_READCHAN_MASK) << RDA5807M_CHAN_SHIFT);
+    presets[slot].flags = RDA5807M_PRESET_USED |
+        (RDA5807MBandIndex(tuning, blend) == RDA5807M_BAND_EAST_50M ?
+         RDA5807M_PRESET_EAST50M : 0x00);
+    presets[slot].rssi = (status.rssi & RDA5807M_RSSI_MASK) >>
+        RDA5807M_RSSI_SHIFT;
+
+    return true;
+};
+
+void RDA5807MPresets::update(byte slot, RDA5807MRDS &rds, byte rssi) {
+    presets[slot].rssi = rssi;
+    if (!rds.getPI())
+        return;
+
+    presets[slot].pi = rds.getPI();
+    memcpy(presets[slot].ps, rds.getPS(), RDA5807M_RDS_PS_LENGTH);
+};
+
+bool RDA5807MPresets::recall(byte slot, RDA5807M &radio) {
+    const TRDA5807MPreset &preset = presets[slot];
+
+    if (!(preset.flags & RDA5807M_PRESET_USED))
+        return false;
+
+    if ((preset.tuning & RDA5807M_BAND_MASK) == RDA5807M_BAND_EAST) {
+        const bool east50M = preset.flags & RDA5807M_PRESET_EAST50M;
+
+        if (!(radio.getShadowRegister(RDA5807M_REG_BLEND) &
+              RDA5807M_FLG_EASTBAND65M) != east50M &&
+            !radio.setBand(RDA5807M_BAND_EAST, east50M))
+            return false;
+    };
+
+    return radio.setTuning(preset.tuning);
+};
+
+word RDA5807MPresets::getFrequency(byte slot) {
+    const TRDA5807MPreset &preset = presets[slot];
+
+    if (!(preset.flags & RDA5807M_PRESET_USED))
+        return 0;
+
+    return RDA5807MChannelFrequency(
+        RDA5807MBandIndex(preset.tuning,
+                          preset.flags & RDA5807M_PRESET_EAST50M ? 0x00 :
+                          RDA5807M_FLG_EASTBAND65M),
+        preset.tuning & RDA5807M_SPACE_MASK,
+        preset.tuning >> RDA5807M_CHAN_SHIFT);
+};
+
+void RDA5807MPresets::save(TWriter writer, void *context) {
+    byte sum = 0x00;
+    word offset = 0;
+
+    //Keeps the running checksum along the way
+#define RDA5807M_PRESETS_PUT(value) do { \
+        const byte b = (value); \
+        sum += b; \
+        writer(offset++, b, context); \
+    } while (0)
+
+    RDA5807M_PRESETS_PUT(highByte(RDA5807M_PRESETS_MAGIC));
+    RDA5807M_PRESETS_PUT(lowByte(RDA5807M_PRESETS_MAGIC));
+    RDA5807M_PRESETS_PUT(RDA5807M_PRESETS_VERSION);
+    RDA5807M_PRESETS_PUT(RDA5807M_PRESETS);
+    RDA5807M_PRESETS_PUT(RDA5807M_PRESETS_RECORD_SIZE);
+    for(byte i=0; i < RDA5807M_PRESETS; i++) {
+        const TRDA5807MPreset &preset = presets[i];
+
+        RDA5807M_PRESETS_PUT(highByte(preset.tuning));
+        RDA5807M_PRESETS_PUT(lowByte(preset.tuning));
+        RDA5807M_PRESETS_PUT(preset.flags);
+        RDA5807M_PRESETS_PUT(preset.rssi);
+        RDA5807M_PRESETS_PUT(highByte(preset.pi));
+        RDA5807M_PRESETS_PUT(lowByte(preset.pi));
+        for(byte j=0; j < RDA5807M_RDS_PS_LENGTH; j++)
+            RDA5807M_PRESETS_PUT(preset.ps[j]);
+    };
+#undef RDA5807M_PRESETS_PUT
+    writer(offset, 0xFF - sum, context);
+};
+
+bool RDA5807MPresets::load(TReader reader, void *context, word size) {
+    if (size < RDA5807M_PRESETS_HEADER_SIZE + 1 ||
+        word(reader(0, context), reader(1, context)) !=
+        RDA5807M_PRESETS_MAGIC ||
+        reader(2, context) != RDA5807M_PRESETS_VERSION)
+        return false;
+
+    const byte count = reader(3, context);
+    const byte length = reader(4, context);
+
+    if (length < RDA5807M_PRESETS_RECORD_SIZE ||
+        RDA5807M_PRESETS_HEADER_SIZE + (unsigned long)count * length + 1 >
+        size)
+        return false;
+    size = RDA5807M_PRESETS_HEADER_SIZE + (word)count * length + 1;
+
+    byte sum = 0x00;
+
+    for(word i=0; i < size; i++)
+        sum += reader(i, context);
+    if (sum != 0xFF)
+        return false;
+
+    clear();
+    for(byte i=0; i < count && i < RDA5807M_PRESETS; i++) {
+        TRDA5807MPreset &preset = presets[i];
+        word offset = RDA5807M_PRESETS_HEADER_SIZE + (word)i * length;
+
+        preset.tuning = word(reader(offset, context),
+                             reader(offset + 1, context));
+        preset.flags = reader(offset + 2, context);
+        preset.rssi = reader(offset + 3, context);
+        preset.pi = word(reader(offset + 4, context),
+                         reader(offset + 5, context));
+        offset += 6;
+        for(byte j=0; j < RDA5807M_RDS_PS_LENGTH; j++)
+            preset.ps[j] = reader(offset + j, context);
+        preset.ps[RDA5807M_RDS_PS_LENGTH] = '\0';
+    };
+
+    return true;
+};
+
+typedef struct {
+    byte *buffer;
+    const byte *source;
+} TRDA5807MPresetsBuffer;
+
+static void writeBuffer(word offset, byte value, void *context) {
+    ((TRDA5807MPresetsBuffer *)context)->buffer[offset] = value;
+};
+
+static byte readBuffer(word offset, void *context) {
+    return ((TRDA5807MPresetsBuffer *)context)->source[offset];
+};
+
+word RDA5807MPresets::save(byte buffer[], word size) {
+    if (size < RDA5807M_PRESETS_SIZE)
+        return 0;
+
+    TRDA5807MPresetsBuffer context = { buffer, NULL };
+
+    save(writeBuffer, &context);
+
+    return RDA5807M_PRESETS_SIZE;
+};
+
+bool RDA5807MPresets::load(const byte buffer[], word size) {
+    TRDA5807MPresetsBuffer context = { NULL, buffer };
+
+    return load(readBuffer, &context, size);
+};
+
+#if defined(__AVR__)
+static void writeEEPROM(word offset, byte value, void *context) {
+    EEPROM.update(*(word *)context + offset, value);
+};
+
+static byte readEEPROM(word offset, void *context) {
+    return EEPROM.read(*(word *)context + offset);
+};
+
+void RDA5807MPresets::saveEEPROM(word address) {
+    save(writeEEPROM, &address);
+};
+
+bool RDA5807MPresets::loadEEPROM(word address) {
+    if (address >= EEPROM.length())
+        return false;
+
+    return load(readEEPROM, &address, EEPROM.length() - address);
+};
+#elif !defined(ARDUINO)
+//Writes are sequential, reads are not
+static void writeFile(word, byte value, void *context) {
+    fputc(value, (FILE *)context);
+};
+
+static byte readFile(word offset, void *context) {
+    FILE *file = (FILE *)context;
+
+    fseek(file, offset, SEEK_SET);
+
+    return fgetc(file);
+};
+
+bool RDA5807MPresets::save(const char *path) {
+    FILE *file = fopen(path, "wb");
+
+    if (!file)
+        return false;
+
+    save(writeFile, file);
+
+    const bool failed = ferror(file);
+
+    return !(fclose(file) || failed);
+};
+
+bool RDA5807MPresets::load(const char *path) {
+    FILE *file = fopen(path, "rb");
+
+    if (!file)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+
+    const long size = ftell(file);
+    const bool result = size > 0 &&
+        load(readFile, file, size > 0xFFFF ? 0xFFFF : (word)size);
+
+    fclose(file);
+
+    return result;
+};
+#endif
@@ -0,0 +1,176 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the preset bank: stations kept as ready to
+ * write RDA5807M_REG_TUNING values, so recalling one is a single register
+ * write, together with what was last known about them (PI, PS, RSSI). The
+ * bank saves to and loads from EEPROM on AVR or a file on a host.
+ */
+
+#ifndef _RDA5807M_PRESETS_H_INCLUDED
+#define _RDA5807M_PRESETS_H_INCLUDED
+
+#include "RDA5807M.h"
+#include "RDA5807M-RDS.h"
+
+//Number of presets in a bank. Define it when building the library (not just
+//the sketch) to change it.
+#if !defined(RDA5807M_PRESETS)
+# define RDA5807M_PRESETS 16
+#endif
+
+//Preset flags
+#define RDA5807M_PRESET_USED 0x01
+#define RDA5807M_PRESET_EAST50M 0x02
+
+//Saved format: a header (magic, version, number of records, record size),
+//the records and a checksum byte making all bytes add up to 0xFF. Fields may
+//be appended to the record without a new version: readers skip whatever a
+//longer record has past the fields they know. Words are stored big-endian,
+//the way the chip has them.
+#define RDA5807M_PRESETS_MAGIC 0x5250
+#define RDA5807M_PRESETS_VERSION 1
+#define RDA5807M_PRESETS_HEADER_SIZE 5
+//tuning (2), flags (1), rssi (1), pi (2), ps (8)
+#define RDA5807M_PRESETS_RECORD_SIZE (6 + RDA5807M_RDS_PS_LENGTH)
+#define RDA5807M_PRESETS_SIZE (RDA5807M_PRESETS_HEADER_SIZE + \
+                               RDA5807M_PRESETS * \
+                               RDA5807M_PRESETS_RECORD_SIZE + 1)
+
+typedef struct {
+    word tuning; //RDA5807M_REG_TUNING: channel, band and spacing
+    byte flags; //RDA5807M_PRESET_* flags
+    byte rssi; //When last stored or updated
+    word pi; //0 if unknown
+    char ps[RDA5807M_RDS_PS_LENGTH + 1]; //Empty if unknown
+} TRDA5807MPreset;
+
+class RDA5807MPresets
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, it starts with every preset empty.
+        */
+        RDA5807MPresets(void) { clear(); };
+
+        /*
+        * Description:
+        *   Empties one preset or, without a slot, the whole bank.
+        */
+        void clear(void);
+        void clear(byte slot) { memset(&presets[slot], 0x00,
+                                       sizeof(presets[slot])); };
+
+        /*
+        * Description:
+        *   Stores a station given by frequency, working out its tuning value
+        *   once, now, rather than at every recall.
+        * Parameters:
+        *   slot      - 0 to RDA5807M_PRESETS - 1.
+        *   frequency - in 10kHz units.
+        *   band      - one of the RDA5807M_BAND_* constants.
+        *   space     - one of the RDA5807M_SPACE_* constants.
+        *   east50M   - with RDA5807M_BAND_EAST, use 50-76MHz instead of
+        *               65-76MHz.
+        * Returns:
+        *   false if frequency isn't a channel of band at that spacing.
+        */
+        bool set(byte slot, word frequency, byte band = RDA5807M_BAND_WEST,
+                 byte space = RDA5807M_SPACE_100K, bool east50M = false);
+
+        /*
+        * Description:
+        *   Stores the station the radio is tuned to now (e.g. after a seek),
+        *   with its RSSI. Costs one status read.
+        * Returns:
+        *   false if the radio is in direct frequency mode, which isn't on any
+        *   channel.
+        */
+        bool store(byte slot, RDA5807M &radio);
+
+        /*
+        * Description:
+        *   Caches what RDS and the radio say about a preset's station, to be
+        *   shown before any RDS comes in after the next recall.
+        */
+        void update(byte slot, RDA5807MRDS &rds, byte rssi);
+
+        /*
+        * Description:
+        *   Tunes the radio to a preset: one register write, plus one to
+        *   change the 65/50MHz selection if an RDA5807M_BAND_EAST preset
+        *   needs it. Use tick() or poll() to find out when it settles.
+        * Returns:
+        *   false, without touching the bus, for an empty preset or a band
+        *   the chip lacks.
+        */
+        bool recall(byte slot, RDA5807M &radio);
+
+        /*
+        * Description:
+        *   Getters for a preset.
+        */
+        bool isUsed(byte slot) {
+            return presets[slot].flags & RDA5807M_PRESET_USED;
+        };
+        word getFrequency(byte slot);
+        const TRDA5807MPreset &get(byte slot) { return presets[slot]; };
+
+        /*
+        * Description:
+        *   Saves the bank in the format described at
+        *   RDA5807M_PRESETS_MAGIC, RDA5807M_PRESETS_SIZE bytes long.
+        * Returns:
+        *   the number of bytes written, 0 if buffer is too small.
+        */
+        word save(byte buffer[], word size);
+
+        /*
+        * Description:
+        *   Loads the bank from the format described at
+        *   RDA5807M_PRESETS_MAGIC. Presets beyond what was saved are emptied,
+        *   presets beyond RDA5807M_PRESETS are ignored.
+        * Returns:
+        *   false, leaving the bank alone, if the data is truncated, corrupt
+        *   or of an unknown version.
+        */
+        bool load(const byte buffer[], word size);
+
+#if defined(__AVR__)
+        /*
+        * Description:
+        *   The same, in EEPROM starting at address. Saving only writes the
+        *   bytes that changed, to spare the EEPROM.
+        */
+        void saveEEPROM(word address);
+        bool loadEEPROM(word address);
+#elif !defined(ARDUINO)
+        /*
+        * Description:
+        *   The same, in a file.
+        * Returns:
+        *   false if the file can't be written or read.
+        */
+        bool save(const char *path);
+        bool load(const char *path);
+#endif
+
+    private:
+        TRDA5807MPreset presets[RDA5807M_PRESETS];
+
+        //Byte at a time access to wherever the bank is saved
+        typedef void (*TWriter)(word offset, byte value, void *context);
+        typedef byte (*TReader)(word offset, void *context);
+
+        void save(TWriter writer, void *context);
+        bool load(TReader reader, void *context, word size);
+};
+
+#endif
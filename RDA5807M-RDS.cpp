@@ -0,0 +1,175 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the RDS/RBDS group decoder.
+ * See the header file for better function documentation.
+ */
+
+#include "RDA5807M-RDS.h"
+
+void RDA5807MRDS::reset(void) {
+    memset(&stats, 0x00, sizeof(stats));
+    changes = 0x00;
+    pi = 0x0000;
+    pty = 0;
+    tp = ta = false;
+    memset(ps, ' ', RDA5807M_RDS_PS_LENGTH);
+    ps[RDA5807M_RDS_PS_LENGTH] = '\0';
+    memset(psVotes, 0x00, RDA5807M_RDS_PS_LENGTH);
+    memset(rt, ' ', RDA5807M_RDS_RT_LENGTH);
+    rt[RDA5807M_RDS_RT_LENGTH] = '\0';
+    memset(rtVotes, 0x00, RDA5807M_RDS_RT_LENGTH);
+    rtAB = false;
+    memset(&ct, 0x00, sizeof(ct));
+    afCount = afExpected = 0;
+};
+
+bool RDA5807MRDS::decode(const TRDA5807MStatus &status) {
+    if (!(status.status & RDA5807M_STATUS_RDSR))
+        return false;
+
+    return decode(status.rds,
+                  (status.rssi & RDA5807M_BLERA_MASK) >> 2,
+                  status.rssi & RDA5807M_BLERB_MASK);
+};
+
+void RDA5807MRDS::vote(char *field, char *candidate, byte *votes,
+                       byte position, char value, byte weight, byte flag) {
+    if (votes[position] && candidate[position] == value) {
+        if (votes[position] <= 0xFF - weight)
+            votes[position] += weight;
+    } else {
+        //Disagreement, the newcomer has to earn its place from scratch
+        candidate[position] = value;
+        votes[position] = weight;
+    };
+
+    if (votes[position] >= confidence && field[position] != value) {
+        field[position] = value;
+        changes |= flag;
+    };
+};
+
+void RDA5807MRDS::decodeAF(byte code) {
+    if (code >= 224 && code <= 249) {
+        //Number of AFs to follow, a new count means a new list
+        if (afExpected != code - 224) {
+            afExpected = code - 224;
+            afCount = 0;
+            changes |= RDA5807M_RDS_AF;
+        };
+    } else if (code >= 1 && code <= 204) {
+        for(byte i=0; i < afCount; i++)
+            if (af[i] == code)
+                return;
+        if (afCount < RDA5807M_RDS_AF_MAX) {
+            af[afCount++] = code;
+            changes |= RDA5807M_RDS_AF;
+        };
+    };
+    //Everything else is either filler or LF/MF, neither of which we do
+};
+
+bool RDA5807MRDS::decode(const word blocks[4], byte blerA, byte blerB) {
+    const word b = blocks[1], c = blocks[2], d = blocks[3];
+    const byte group = b >> RDA5807M_RDS_GROUP_SHIFT;
+    const bool versionB = b & RDA5807M_RDS_VERSIONB;
+
+    stats.received++;
+    //Without a trustworthy block B we don't even know what we're looking at
+    if (blerB > maxBlerB) {
+        stats.rejected++;
+
+        return false;
+    };
+    stats.accepted++;
+
+    //The chip only reports error levels for blocks A and B, the worse of
+    //the two stands in for the whole group.
+    const bool clean = (blerA == RDA5807M_RDS_BLER_NONE &&
+                        blerB == RDA5807M_RDS_BLER_NONE);
+    const byte weight = clean ? 2 : 1;
+
+    if (blerA <= maxBlerA && pi != blocks[0]) {
+        pi = blocks[0];
+        changes |= RDA5807M_RDS_PI;
+    };
+    if (pty != (b & RDA5807M_RDS_PTY_MASK) >> RDA5807M_RDS_PTY_SHIFT) {
+        pty = (b & RDA5807M_RDS_PTY_MASK) >> RDA5807M_RDS_PTY_SHIFT;
+        changes |= RDA5807M_RDS_PTY;
+    };
+    if (tp != (bool)(b & RDA5807M_RDS_TP)) {
+        tp = b & RDA5807M_RDS_TP;
+        changes |= RDA5807M_RDS_TRAFFIC;
+    };
+
+    switch (group) {
+        case 0x0:
+            if (ta != (bool)(b & RDA5807M_RDS_TA)) {
+                ta = b & RDA5807M_RDS_TA;
+                changes |= RDA5807M_RDS_TRAFFIC;
+            };
+            vote(ps, psCandidate, psVotes, (b & 0x03) * 2, highByte(d),
+                 weight, RDA5807M_RDS_PS);
+            vote(ps, psCandidate, psVotes, (b & 0x03) * 2 + 1, lowByte(d),
+                 weight, RDA5807M_RDS_PS);
+            if (!versionB && clean) {
+                //A code 250 means the next one is a LF/MF frequency
+                if (highByte(c) == 250)
+                    break;
+                decodeAF(highByte(c));
+                decodeAF(lowByte(c));
+            };
+            break;
+        case 0x2: {
+            //A/B flag toggle means a whole new text is on its way
+            if (rtAB != (bool)(b & RDA5807M_RDS_ABFLAG)) {
+                rtAB = b & RDA5807M_RDS_ABFLAG;
+                memset(rt, ' ', RDA5807M_RDS_RT_LENGTH);
+                memset(rtVotes, 0x00, RDA5807M_RDS_RT_LENGTH);
+                changes |= RDA5807M_RDS_RT;
+            };
+
+            const byte segment = b & 0x0F;
+            char text[4];
+            byte count;
+
+            if (versionB) {
+                text[0] = highByte(d);
+                text[1] = lowByte(d);
+                count = 2;
+            } else {
+                text[0] = highByte(c);
+                text[1] = lowByte(c);
+                text[2] = highByte(d);
+                text[3] = lowByte(d);
+                count = 4;
+            };
+            for(byte i=0; i < count; i++)
+                //Carriage return marks the end of a shorter text
+                vote(rt, rtCandidate, rtVotes, segment * count + i,
+                     text[i] == '\r' ? '\0' : text[i], weight,
+                     RDA5807M_RDS_RT);
+            break;
+        };
+        case 0x4:
+            if (versionB || !clean)
+                break;
+            ct.mjd = ((unsigned long)(b & 0x03) << 15) | (c >> 1);
+            ct.hour = ((c & 0x01) << 4) | (d >> 12);
+            ct.minute = (d >> 6) & 0x3F;
+            ct.offset = d & 0x1F;
+            if (d & 0x20)
+                ct.offset = -ct.offset;
+            changes |= RDA5807M_RDS_CT;
+            break;
+    };
+
+    return true;
+};
@@ -0,0 +1,217 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the RDS/RBDS group decoder.
+ */
+
+#ifndef _RDA5807M_RDS_H_INCLUDED
+#define _RDA5807M_RDS_H_INCLUDED
+
+#include "RDA5807M.h"
+
+//Decoded field change flags, see RDA5807MRDS::getChanges()
+#define RDA5807M_RDS_PI 0x01
+#define RDA5807M_RDS_PTY 0x02
+#define RDA5807M_RDS_TRAFFIC 0x04
+#define RDA5807M_RDS_PS 0x08
+#define RDA5807M_RDS_RT 0x10
+#define RDA5807M_RDS_CT 0x20
+#define RDA5807M_RDS_AF 0x40
+
+//Field sizes, as per IEC 62106
+#define RDA5807M_RDS_PS_LENGTH 8
+#define RDA5807M_RDS_RT_LENGTH 64
+#define RDA5807M_RDS_AF_MAX 25
+
+//Block B layout
+#define RDA5807M_RDS_GROUP_SHIFT 12
+#define RDA5807M_RDS_VERSIONB 0x0800
+#define RDA5807M_RDS_TP 0x0400
+#define RDA5807M_RDS_PTY_MASK 0x03E0
+#define RDA5807M_RDS_PTY_SHIFT 5
+#define RDA5807M_RDS_TA word(0x0010)
+#define RDA5807M_RDS_ABFLAG word(0x0010)
+
+//Block error levels, as reported by the chip in RDA5807M_REG_RSSI
+#define RDA5807M_RDS_BLER_NONE 0x0
+#define RDA5807M_RDS_BLER_12 0x1
+#define RDA5807M_RDS_BLER_35 0x2
+#define RDA5807M_RDS_BLER_FAIL 0x3
+
+//Clock-time and date, as carried by group 4A.
+typedef struct {
+    unsigned long mjd; //Modified Julian Day
+    byte hour; //UTC
+    byte minute; //UTC
+    int8_t offset; //Local time offset, in half hours
+} TRDA5807MClockTime;
+
+//Group reception statistics, see RDA5807MRDS::getStatistics()
+typedef struct {
+    unsigned long received;
+    unsigned long accepted;
+    unsigned long rejected;
+} TRDA5807MRDSStats;
+
+class RDA5807MRDS
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, it initializes internal data structures.
+        */
+        RDA5807MRDS(void) : maxBlerA(RDA5807M_RDS_BLER_12),
+                            maxBlerB(RDA5807M_RDS_BLER_12), confidence(2) {
+            reset();
+        };
+
+        /*
+        * Description:
+        *   Forgets everything decoded so far and clears the statistics, call
+        *   after tuning to a new station.
+        */
+        void reset(void);
+
+        /*
+        * Description:
+        *   Decodes one RDS group and updates whatever fields it carries.
+        *   Groups whose block B error level exceeds the configured limit are
+        *   rejected outright, PI is only taken from a block A within limits.
+        *   PS and RadioText characters are voted on: an error-free group
+        *   casts two votes per character, a group with corrected errors one,
+        *   and a character only shows once it has gathered enough agreeing
+        *   votes in its position. Clock-time and AF codes have no such
+        *   redundancy and are only taken from error-free groups.
+        * Parameters:
+        *   blocks - the four blocks of the group, A through D.
+        *   blerA  - block A error level, one of RDA5807M_RDS_BLER_*.
+        *   blerB  - block B error level, one of RDA5807M_RDS_BLER_*.
+        * Returns:
+        *   true if the group was accepted, false otherwise.
+        */
+        bool decode(const word blocks[4],
+                    byte blerA = RDA5807M_RDS_BLER_NONE,
+                    byte blerB = RDA5807M_RDS_BLER_NONE);
+
+        /*
+        * Description:
+        *   Decodes the RDS group held by a status snapshot, if any, using the
+        *   block error levels the chip reported alongside it.
+        * Parameters:
+        *   status - status snapshot, as returned by RDA5807M::getStatus().
+        * Returns:
+        *   true if the snapshot held a new group and it was accepted, false
+        *   otherwise.
+        */
+        bool decode(const TRDA5807MStatus &status);
+
+        /*
+        * Description:
+        *   Decodes a raw RDS group, e.g. one taken off an RDA5807MRDSQueue,
+        *   using the block error levels it was read with.
+        */
+        bool decode(const TRDA5807MRDSGroup &group) {
+            return decode(group.blocks,
+                          (group.bler & RDA5807M_BLERA_MASK) >> 2,
+                          group.bler & RDA5807M_BLERB_MASK);
+        };
+
+        /*
+        * Description:
+        *   Sets the worst block error levels still accepted. Defaults to
+        *   RDA5807M_RDS_BLER_12 for both blocks.
+        * Parameters:
+        *   blerA - limit for block A (PI), one of RDA5807M_RDS_BLER_*.
+        *   blerB - limit for block B (group type), one of RDA5807M_RDS_BLER_*.
+        */
+        void setBLERLimits(byte blerA, byte blerB) {
+            maxBlerA = blerA;
+            maxBlerB = blerB;
+        };
+
+        /*
+        * Description:
+        *   Sets how many agreeing votes a PS or RadioText character needs
+        *   before it is shown. Lower is faster to display, higher is more
+        *   robust on weak signals. Defaults to 2.
+        * Parameters:
+        *   votes - number of votes, 1 to 255.
+        */
+        void setConfidence(byte votes) { confidence = votes; };
+
+        /*
+        * Description:
+        *   Returns the number of groups received, accepted and rejected since
+        *   the last reset().
+        */
+        const TRDA5807MRDSStats &getStatistics(void) { return stats; };
+
+        /*
+        * Description:
+        *   Returns the fields that changed since the last call as a
+        *   combination of the RDA5807M_RDS_* flags and clears them.
+        */
+        byte getChanges(void) {
+            const byte result = changes;
+
+            changes = 0x00;
+
+            return result;
+        };
+
+        /*
+        * Description:
+        *   Getters for the decoded fields. Strings are always NUL-terminated
+        *   and use the RDS character set, which matches ASCII in the
+        *   printable range.
+        */
+        word getPI(void) { return pi; };
+        byte getPTY(void) { return pty; };
+        bool getTP(void) { return tp; };
+        bool getTA(void) { return ta; };
+        const char *getPS(void) { return ps; };
+        const char *getRadioText(void) { return rt; };
+        const TRDA5807MClockTime &getClockTime(void) { return ct; };
+
+        /*
+        * Description:
+        *   Getters for the Alternative Frequencies list (method A).
+        * Parameters:
+        *   index - list entry, 0 to getAFCount() - 1.
+        * Returns:
+        *   number of entries or the frequency of the given entry, in 10kHz
+        *   units.
+        */
+        byte getAFCount(void) { return afCount; };
+        word getAF(byte index) { return 8750 + af[index] * 10; };
+
+    private:
+        byte maxBlerA, maxBlerB, confidence;
+        TRDA5807MRDSStats stats;
+        byte changes;
+        word pi;
+        byte pty;
+        bool tp, ta;
+        char ps[RDA5807M_RDS_PS_LENGTH + 1];
+        char psCandidate[RDA5807M_RDS_PS_LENGTH];
+        byte psVotes[RDA5807M_RDS_PS_LENGTH];
+        char rt[RDA5807M_RDS_RT_LENGTH + 1];
+        char rtCandidate[RDA5807M_RDS_RT_LENGTH];
+        byte rtVotes[RDA5807M_RDS_RT_LENGTH];
+        bool rtAB;
+        TRDA5807MClockTime ct;
+        byte af[RDA5807M_RDS_AF_MAX];
+        byte afCount, afExpected;
+
+        void decodeAF(byte code);
+        void vote(char *field, char *candidate, byte *votes, byte position,
+                  char value, byte weight, byte flag);
+};
+
+#endif
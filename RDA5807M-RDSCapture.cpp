@@ -0,0 +1,219 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for raw RDS capture and replay.
+ * See the header file for better function documentation.
+ */
+
+#include "RDA5807M-RDSCapture.h"
+
+void RDA5807MCaptureHeader(byte header[]) {
+    header[0] = highByte(RDA5807M_CAPTURE_MAGIC);
+    header[1] = lowByte(RDA5807M_CAPTURE_MAGIC);
+    header[2] = RDA5807M_CAPTURE_VERSION;
+    header[3] = RDA5807M_CAPTURE_RECORD_SIZE;
+};
+
+void RDA5807MCaptureUnpack(const byte record[],
+                           TRDA5807MCaptureRecord &unpacked) {
+    unpacked.time = (unsigned long)word(record[0], record[1]) << 16 |
+        word(record[2], record[3]);
+    unpacked.frequency = word(record[4], record[5]);
+    for(byte i=0; i < 4; i++)
+        unpacked.blocks[i] = word(record[6 + i * 2], record[7 + i * 2]);
+    unpacked.rssi = record[14];
+    unpacked.flags = record[15];
+};
+
+void RDA5807MCaptureGroup(const TRDA5807MCaptureRecord &record,
+                          TRDA5807MRDSGroup &group) {
+    for(byte i=0; i < 4; i++)
+        group.blocks[i] = record.blocks[i];
+    group.bler = record.flags & (RDA5807M_CAPTURE_BLERA_MASK |
+                                 RDA5807M_CAPTURE_BLERB_MASK);
+    group.time = record.time;
+};
+
+static char *hexWord(char *line, word value) {
+    static const char digits[] = "0123456789ABCDEF";
+
+    for(byte shift=16; shift; line++) {
+        shift -= 4;
+        *line = digits[(value >> shift) & 0x0F];
+    };
+
+    return line;
+};
+
+void RDA5807MCaptureSpyLine(const TRDA5807MCaptureRecord &record,
+                            char line[]) {
+    for(byte i=0; i < 4; i++) {
+        if (i)
+            *line++ = ' ';
+        if ((i == 0 && (record.flags & RDA5807M_CAPTURE_BLERA_MASK) ==
+             RDA5807M_BLERA_U) ||
+            (i == 1 && (record.flags & RDA5807M_CAPTURE_BLERB_MASK) ==
+             RDA5807M_BLERB_U)) {
+            memset(line, '-', 4);
+            line += 4;
+        } else
+            line = hexWord(line, record.blocks[i]);
+    };
+    *line = '\0';
+};
+
+bool RDA5807MRDSReplay::readBuffer(byte data[], byte count, void *context) {
+    RDA5807MRDSReplay &replay = *(RDA5807MRDSReplay *)context;
+
+    if (replay.size - replay.offset < count)
+        return false;
+
+    memcpy(data, replay.data + replay.offset, count);
+    replay.offset += count;
+
+    return true;
+};
+
+bool RDA5807MRDSReplay::open(TRDA5807MCaptureReader reader, void *context) {
+    byte header[RDA5807M_CAPTURE_HEADER_SIZE];
+
+    this->reader = reader;
+    this->context = context;
+    speed = 0;
+    started = pending = false;
+    finished = true;
+    count = 0;
+    if (!reader || !reader(header, sizeof(header), context) ||
+        word(header[0], header[1]) != RDA5807M_CAPTURE_MAGIC ||
+        header[2] != RDA5807M_CAPTURE_VERSION ||
+        header[3] < RDA5807M_CAPTURE_RECORD_SIZE)
+        return false;
+
+    length = header[3];
+    finished = false;
+
+    return true;
+};
+
+bool RDA5807MRDSReplay::open(const byte data[], unsigned long size) {
+    this->data = data;
+    this->size = size;
+    offset = 0;
+
+    return open(readBuffer, this);
+};
+
+#if !defined(ARDUINO)
+static bool readFile(byte data[], byte count, void *context) {
+    return fread(data, 1, count, (FILE *)context) == count;
+};
+
+bool RDA5807MRDSReplay::open(FILE *file) {
+    return open(readFile, file);
+};
+#endif
+
+bool RDA5807MRDSReplay::next(TRDA5807MCaptureRecord &record) {
+    if (!pending && !fetch())
+        return false;
+
+    record = held;
+    pending = false;
+    count++;
+
+    return true;
+};
+
+bool RDA5807MRDSReplay::fetch(void) {
+    byte buffer[RDA5807M_CAPTURE_RECORD_SIZE];
+    bool ok = !finished && reader(buffer, sizeof(buffer), context);
+
+    //Fields from a later version, skipped a record's worth at a time
+    for(byte left = length - sizeof(buffer); ok && left;) {
+        byte chunk[RDA5807M_CAPTURE_RECORD_SIZE];
+        const byte step = left < sizeof(chunk) ? left : sizeof(chunk);
+
+        ok = reader(chunk, step, context);
+        left -= step;
+    };
+    if (!ok) {
+        finished = true;
+
+        return false;
+    };
+    RDA5807MCaptureUnpack(buffer, held);
+    pending = true;
+
+    return true;
+};
+
+word RDA5807MRDSReplay::service(RDA5807MRDS &rds, unsigned long now) {
+    TRDA5807MRDSGroup group;
+    word decoded = 0;
+
+    while (pending || fetch()) {
+        if (speed) {
+            if (!started) {
+                first = held.time;
+                start = now;
+                started = true;
+            };
+            //Not due yet: keep it for the next call
+            if ((held.time - first) / speed > now - start)
+                break;
+        };
+        RDA5807MCaptureGroup(held, group);
+        rds.decode(group);
+        pending = false;
+        count++;
+        decoded++;
+    };
+
+    return decoded;
+};
+
+#if defined(RDA5807M_BUS_SIMULATOR)
+word RDA5807MRDSReplay::service(RDA5807MSimulator &chip) {
+    word queued = 0;
+
+    while (pending || fetch()) {
+        //Doesn't fit: keep it for the next call
+        if (!chip.injectGroup(held.blocks, held.flags &
+                              (RDA5807M_CAPTURE_BLERA_MASK |
+                               RDA5807M_CAPTURE_BLERB_MASK)))
+            break;
+        pending = false;
+        count++;
+        queued++;
+    };
+
+    return queued;
+};
+#endif
+
+#if !defined(ARDUINO)
+long RDA5807MCaptureToSpy(FILE *in, FILE *out) {
+    RDA5807MRDSReplay replay;
+    TRDA5807MCaptureRecord record;
+    char line[RDA5807M_CAPTURE_SPY_LENGTH];
+    long converted = 0;
+
+    if (!replay.open(in))
+        return -1;
+
+    while (replay.next(record)) {
+        RDA5807MCaptureSpyLine(record, line);
+        if (fprintf(out, "%s\n", line) < 0)
+            return -1;
+        converted++;
+    };
+
+    return converted;
+};
+#endif
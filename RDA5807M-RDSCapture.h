@@ -0,0 +1,351 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for raw RDS capture: a compact binary format for
+ * recording groups as they come out of RDA5807M_REG_RDSA through
+ * RDA5807M_REG_RDSD, a ring buffer recording into it with bounded memory, an
+ * exporter to the RDS Spy text format and a replay source feeding captures
+ * back into RDA5807MRDS or the chip simulator.
+ */
+
+#ifndef _RDA5807M_RDSCAPTURE_H_INCLUDED
+#define _RDA5807M_RDSCAPTURE_H_INCLUDED
+
+#include "RDA5807M.h"
+#include "RDA5807M-RDS.h"
+#include "RDA5807M-RDSQueue.h"
+
+#if !defined(ARDUINO)
+# include <stdio.h>
+#endif
+
+//Capture stream layout, all multi-byte fields big-endian. A header:
+// - magic (2 bytes), version and record size (1 byte each);
+//then, appended one per group, records of:
+// - time (4 bytes), in milliseconds;
+// - frequency (2 bytes), in 10kHz units;
+// - blocks A through D (2 bytes each);
+// - RSSI (1 byte);
+// - flags (1 byte), see below.
+//Newer versions may only ever append fields to a record, readers skip what
+//they don't know about.
+#define RDA5807M_CAPTURE_MAGIC 0x5243 //"RC"
+#define RDA5807M_CAPTURE_VERSION 1
+#define RDA5807M_CAPTURE_HEADER_SIZE 4
+#define RDA5807M_CAPTURE_RECORD_SIZE 16
+
+//Record flags: chip status bits at the time and the block error levels, in
+//the same place as in RDA5807M_REG_RSSI
+#define RDA5807M_CAPTURE_FLG_RDSS 0x80
+#define RDA5807M_CAPTURE_FLG_BLKE 0x40
+#define RDA5807M_CAPTURE_FLG_ST 0x20
+#define RDA5807M_CAPTURE_BLERA_MASK RDA5807M_BLERA_MASK
+#define RDA5807M_CAPTURE_BLERB_MASK RDA5807M_BLERB_MASK
+
+//Length of an RDS Spy line, terminating NUL included
+#define RDA5807M_CAPTURE_SPY_LENGTH 20
+
+//One record, unpacked.
+typedef struct {
+    unsigned long time; //In milliseconds
+    word frequency; //In 10kHz units
+    word blocks[4]; //A through D
+    byte rssi;
+    byte flags; //RDA5807M_CAPTURE_FLG_* and BLER bits
+} TRDA5807MCaptureRecord;
+
+/*
+ * Description:
+ *   Packs a group into a capture record, in place.
+ * Parameters:
+ *   record    - RDA5807M_CAPTURE_RECORD_SIZE bytes.
+ *   status    - status snapshot holding the group.
+ *   frequency - what the radio is tuned to, in 10kHz units.
+ *   time      - when the group was read, in milliseconds.
+ */
+static inline void RDA5807MCapturePack(byte record[],
+                                       const TRDA5807MStatus &status,
+                                       word frequency, unsigned long time) {
+    record[0] = time >> 24;
+    record[1] = time >> 16;
+    record[2] = time >> 8;
+    record[3] = time;
+    record[4] = highByte(frequency);
+    record[5] = lowByte(frequency);
+    for(byte i=0; i < 4; i++) {
+        record[6 + i * 2] = highByte(status.rds[i]);
+        record[7 + i * 2] = lowByte(status.rds[i]);
+    };
+    record[14] = (status.rssi & RDA5807M_RSSI_MASK) >> RDA5807M_RSSI_SHIFT;
+    record[15] = (status.rssi & (RDA5807M_BLERA_MASK | RDA5807M_BLERB_MASK)) |
+        (status.status & RDA5807M_STATUS_RDSS ? RDA5807M_CAPTURE_FLG_RDSS : 0) |
+        (status.status & RDA5807M_STATUS_BLKE ? RDA5807M_CAPTURE_FLG_BLKE : 0) |
+        (status.status & RDA5807M_STATUS_ST ? RDA5807M_CAPTURE_FLG_ST : 0);
+};
+
+/*
+ * Description:
+ *   Fills in the stream header, RDA5807M_CAPTURE_HEADER_SIZE bytes.
+ */
+void RDA5807MCaptureHeader(byte header[]);
+
+/*
+ * Description:
+ *   Unpacks a capture record.
+ */
+void RDA5807MCaptureUnpack(const byte record[],
+                           TRDA5807MCaptureRecord &unpacked);
+
+/*
+ * Description:
+ *   The RDS group in a record, as RDA5807MRDS::decode() takes it.
+ */
+void RDA5807MCaptureGroup(const TRDA5807MCaptureRecord &record,
+                          TRDA5807MRDSGroup &group);
+
+/*
+ * Description:
+ *   Formats a record as a line of RDS Spy's hex log format: the four blocks,
+ *   with "----" for block A or B when the chip couldn't correct it (the chip
+ *   reports no error level for C and D). No line terminator.
+ * Parameters:
+ *   line - at least RDA5807M_CAPTURE_SPY_LENGTH characters.
+ */
+void RDA5807MCaptureSpyLine(const TRDA5807MCaptureRecord &record, char line[]);
+
+/*
+ * Recording side: a fixed capacity ring of packed records, filled by one
+ * producer (e.g. the tick() RDS callback or an ISR) and emptied by one
+ * consumer, with the same guarantees as RDA5807MRDSQueue. Records are packed
+ * straight into the ring and handed to the consumer in place, as runs of
+ * whole records ready to be written out (e.g. with Serial.write() or
+ * fwrite()). A full ring drops the newest group and counts it in
+ * getOverflows(). capacity must be a power of two, up to 128.
+ */
+template <byte capacity>
+class RDA5807MRDSCapture
+{
+    static_assert(capacity && capacity <= 128 && !(capacity & (capacity - 1)),
+                  "capacity must be a power of two up to 128");
+
+    public:
+        RDA5807MRDSCapture(void) {};
+
+        /*
+        * Description:
+        *   Producer side: a free record to pack into, which only becomes
+        *   visible to the consumer on commit().
+        * Returns:
+        *   NULL if the ring is full.
+        */
+        byte *reserve(void) {
+            const byte position = head.own();
+
+            if ((byte)(position - tail.acquire()) == capacity) {
+                overflows.increment();
+
+                return NULL;
+            };
+
+            return ring[position & (capacity - 1)];
+        };
+        void commit(void) { head.release(head.own() + 1); };
+
+        /*
+        * Description:
+        *   Producer side: records the RDS group in a status snapshot, if it
+        *   holds a new one.
+        * Returns:
+        *   false if there was no group or the ring was full.
+        */
+        bool push(const TRDA5807MStatus &status, word frequency,
+                  unsigned long time) {
+            if (!(status.status & RDA5807M_STATUS_RDSR))
+                return false;
+
+            byte *record = reserve();
+
+            if (!record)
+                return false;
+            RDA5807MCapturePack(record, status, frequency, time);
+            commit();
+
+            return true;
+        };
+
+        /*
+        * Description:
+        *   Consumer side: the oldest records, in place. A run stops at the
+        *   end of the ring, so it may take two calls to get everything.
+        * Parameters:
+        *   count - set to the number of records in the run, 0 if none.
+        * Returns:
+        *   the first byte of the run, valid until release().
+        */
+        const byte *peek(byte &count) {
+            const byte position = tail.own();
+            const byte index = position & (capacity - 1);
+
+            count = head.acquire() - position;
+            if (count > capacity - index)
+                count = capacity - index;
+
+            return ring[index];
+        };
+        void release(byte count) { tail.release(tail.own() + count); };
+
+        /*
+        * Description:
+        *   As for RDA5807MRDSQueue.
+        */
+        void clear(void) { tail.release(head.acquire()); };
+        word getOverflows(void) const { return overflows.get(); };
+
+        /*
+        * Description:
+        *   Number of records held. A lower bound for the consumer and an
+        *   upper bound for the producer, as the other side may change it at
+        *   any time.
+        */
+        byte getCount(void) const {
+            return head.acquire() - tail.acquire();
+        };
+
+    private:
+        byte ring[capacity][RDA5807M_CAPTURE_RECORD_SIZE];
+        RDA5807MQueueIndex head; //Written by the producer
+        RDA5807MQueueIndex tail; //Written by the consumer
+        RDA5807MQueueCounter overflows; //Written by the producer
+};
+
+/*
+ * Reads a capture stream (header included) from wherever the given function
+ * gets its bytes, one record at a time: it must fill in the next count bytes
+ * of the stream and return false at the end of it.
+ */
+typedef bool (*TRDA5807MCaptureReader)(byte data[], byte count,
+                                       void *context);
+
+/*
+ * Playback side: goes through a capture in order, feeding the groups into an
+ * RDA5807MRDS decoder or, on a host, into the simulated chip, as fast as the
+ * receiving end takes them or at a multiple of the recorded pace.
+ */
+class RDA5807MRDSReplay
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, for a stream read through reader. See
+        *   open() for the other sources.
+        */
+        RDA5807MRDSReplay(TRDA5807MCaptureReader reader = NULL,
+                          void *context = NULL) {
+            open(reader, context);
+        };
+
+        /*
+        * Description:
+        *   Starts over, on a stream read through reader, a capture in memory
+        *   or, on a host, a capture file.
+        * Returns:
+        *   false if the stream doesn't start with a capture header this
+        *   version can read.
+        */
+        bool open(TRDA5807MCaptureReader reader, void *context);
+        bool open(const byte data[], unsigned long size);
+#if !defined(ARDUINO)
+        bool open(FILE *file);
+#endif
+
+        /*
+        * Description:
+        *   The next record in the capture.
+        * Returns:
+        *   false at the end of the capture.
+        */
+        bool next(TRDA5807MCaptureRecord &record);
+
+        /*
+        * Description:
+        *   Replays at speed times the recorded pace from now on: service()
+        *   then hands out a record once its time, counted from the first
+        *   record, is due. 0, the default, replays as fast as the receiving
+        *   end goes.
+        */
+        void setSpeed(word speed) {
+            this->speed = speed;
+            started = false;
+        };
+
+        /*
+        * Description:
+        *   Decodes the records due by now.
+        * Parameters:
+        *   now - current time in milliseconds, as returned by millis().
+        * Returns:
+        *   number of groups decoded.
+        */
+        word service(RDA5807MRDS &rds, unsigned long now);
+        word service(RDA5807MRDS &rds) { return service(rds, millis()); };
+
+#if defined(RDA5807M_BUS_SIMULATOR)
+        /*
+        * Description:
+        *   Queues records for delivery by the simulated chip, until its queue
+        *   is full. The chip hands them out at the RDS group rate, in
+        *   simulated time.
+        * Returns:
+        *   number of groups queued.
+        */
+        word service(RDA5807MSimulator &chip);
+#endif
+
+        /*
+        * Description:
+        *   Returns true once every record has been handed out.
+        */
+        bool isFinished(void) { return finished; };
+
+        /*
+        * Description:
+        *   Records handed out so far.
+        */
+        unsigned long getCount(void) { return count; };
+
+    private:
+        TRDA5807MCaptureReader reader;
+        void *context;
+        //Built-in sources: what they read from and how far they got
+        const byte *data;
+        unsigned long size, offset;
+        byte length; //Record size in the stream
+        word speed;
+        bool started, finished;
+        bool pending; //Holding a record that wasn't due yet or didn't fit
+        unsigned long first, start; //Time of the first record, and when
+        unsigned long count;
+        TRDA5807MCaptureRecord held; //Next one, if pending
+
+        static bool readBuffer(byte data[], byte count, void *context);
+        bool fetch(void);
+};
+
+#if !defined(ARDUINO)
+/*
+ * Description:
+ *   Converts a capture to RDS Spy's hex log format, one line per record.
+ * Returns:
+ *   number of records converted, or -1 if in isn't a capture this version
+ *   can read or out couldn't be written.
+ */
+long RDA5807MCaptureToSpy(FILE *in, FILE *out);
+#endif
+
+#endif
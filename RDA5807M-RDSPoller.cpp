@@ -0,0 +1,111 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the RDS poller.
+ * See the header file for better function documentation.
+ */
+
+#include "RDA5807M-RDSPoller.h"
+
+void RDA5807MRDSPoller::reset(void) {
+    state = RDA5807M_RDSPOLL_START;
+    lead = RDA5807M_RDSPOLL_LEAD_US;
+    early = 0;
+    last = due = 0;
+};
+
+bool RDA5807MRDSPoller::service(TRDA5807MRDSGroup &group, unsigned long now) {
+    if (state != RDA5807M_RDSPOLL_START && (long)(now - due) < 0)
+        return false;
+
+    word regs[RDA5807M_STATUS_SIZE];
+
+    radio.getRegisterBulk(RDA5807M_STATUS_SIZE, regs);
+    stats.polls++;
+
+    //The last read came up empty, so anything new came after it
+    const unsigned long since = now - last;
+
+    last = now;
+    if (!(regs[0] & RDA5807M_STATUS_RDSS)) {
+        //No RDS, or not any more: look less and less often
+        if (state != RDA5807M_RDSPOLL_SEARCH)
+            step = RDA5807M_RDS_GROUP_US;
+        else if (step < RDA5807M_RDSPOLL_BACKOFF_US / 2)
+            step <<= 1;
+        else
+            step = RDA5807M_RDSPOLL_BACKOFF_US;
+        state = RDA5807M_RDSPOLL_SEARCH;
+        due = now + step;
+
+        return false;
+    };
+
+    if (!(regs[0] & RDA5807M_STATUS_RDSR)) {
+        if (state != RDA5807M_RDSPOLL_SYNCED) {
+            state = RDA5807M_RDSPOLL_ACQUIRE;
+            due = now + RDA5807M_RDSPOLL_ACQUIRE_US;
+        } else if (now - anchor > RDA5807M_RDS_GROUP_US +
+                   RDA5807M_RDSPOLL_LEAD_MAX_US) {
+            //Never came (the chip drops groups it can't correct), wait for
+            //the one after
+            stats.missed++;
+            anchor += RDA5807M_RDS_GROUP_US;
+            early = 0;
+            due = anchor + RDA5807M_RDS_GROUP_US - lead;
+        } else {
+            //Early, it's due any moment now
+            early++;
+            due = now + RDA5807M_RDSPOLL_STEP_US;
+        };
+
+        return false;
+    };
+
+    for(byte i=0; i < 4; i++)
+        group.blocks[i] = regs[2 + i];
+    group.bler = regs[1] & (RDA5807M_BLERA_MASK | RDA5807M_BLERB_MASK);
+    group.time = millis();
+    stats.captured++;
+
+    if (state != RDA5807M_RDSPOLL_SYNCED) {
+        //Somewhere since the last read, which was close by if acquiring
+        anchor = state == RDA5807M_RDSPOLL_ACQUIRE ? now - since / 2 : now;
+        lead = RDA5807M_RDSPOLL_LEAD_US;
+        state = RDA5807M_RDSPOLL_SYNCED;
+    } else if (early) {
+        //Between the last read and this one, which is as close as it gets
+        const unsigned long periods = (now - anchor +
+                                       RDA5807M_RDS_GROUP_US / 2) /
+            RDA5807M_RDS_GROUP_US;
+
+        if (periods > 1)
+            stats.missed += periods - 1;
+        anchor = now - since / 2;
+        lead = RDA5807M_RDSPOLL_LEAD_US;
+    } else {
+        //Already there: take it as on schedule, but look earlier next time
+        //in case the schedule has drifted
+        unsigned long periods = (now - anchor + lead) / RDA5807M_RDS_GROUP_US;
+
+        if (!periods)
+            periods = 1;
+        stats.missed += periods - 1;
+        anchor += periods * RDA5807M_RDS_GROUP_US;
+        //It can't have come later than it was seen
+        if ((long)(anchor - now) > 0)
+            anchor = now;
+        if (lead < RDA5807M_RDSPOLL_LEAD_MAX_US)
+            lead <<= 1;
+    };
+    early = 0;
+    due = anchor + RDA5807M_RDS_GROUP_US - lead;
+
+    return true;
+};
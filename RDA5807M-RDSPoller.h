@@ -0,0 +1,130 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the RDS poller, which fetches RDS groups
+ * without interrupts by reading the chip only around the time the next group
+ * is due, rather than as often as the main loop comes around.
+ */
+
+#ifndef _RDA5807M_RDSPOLLER_H_INCLUDED
+#define _RDA5807M_RDSPOLLER_H_INCLUDED
+
+#include "RDA5807M.h"
+
+//One RDS group is 104 bits at 1187.5bps, in microseconds
+#define RDA5807M_RDS_GROUP_US 87579UL
+
+//Poller pacing, in microseconds:
+// - STEP: between reads once a group is late;
+// - LEAD: how much earlier than predicted the next group is first looked
+//   for. It doubles, up to LEAD_MAX, each time the group is already there,
+//   so the prediction keeps being checked against the chip;
+// - ACQUIRE: between reads while the chip has locked on to RDS but no group
+//   has been read yet, which is how close the first prediction gets;
+// - BACKOFF: longest wait between reads while there is no RDS.
+#define RDA5807M_RDSPOLL_STEP_US 1000UL
+#define RDA5807M_RDSPOLL_LEAD_US 250UL
+#define RDA5807M_RDSPOLL_LEAD_MAX_US 8000UL
+#define RDA5807M_RDSPOLL_ACQUIRE_US (RDA5807M_RDS_GROUP_US / 8)
+#define RDA5807M_RDSPOLL_BACKOFF_US (16 * RDA5807M_RDS_GROUP_US)
+
+//Poller states
+#define RDA5807M_RDSPOLL_START 0x0 //Read at the next call
+#define RDA5807M_RDSPOLL_SEARCH 0x1 //No RDS, backing off
+#define RDA5807M_RDSPOLL_ACQUIRE 0x2 //RDS, waiting for the first group
+#define RDA5807M_RDSPOLL_SYNCED 0x3 //Predicting arrivals
+
+//Poller statistics, see RDA5807MRDSPoller::getStats()
+typedef struct {
+    unsigned long polls; //Reads of the chip
+    unsigned long captured; //Groups read
+    unsigned long missed; //Groups that came and went between two reads
+} TRDA5807MRDSPollStats;
+
+/*
+ * Reads RDS groups off an RDA5807M in polled (not interrupt) mode. Once the
+ * chip has locked on to RDS, groups come at a steady RDA5807M_RDS_GROUP_US,
+ * so after the first few the poller knows when the next one is due and only
+ * reads around then: about one read per group, instead of many (with a busy
+ * loop) or a lost group now and then (with a slow one). Without RDS, it reads
+ * less and less often. Every read is RDA5807M_REG_STATUS through
+ * RDA5807M_REG_RDSD in one transaction.
+ */
+class RDA5807MRDSPoller
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, for the given radio.
+        */
+        RDA5807MRDSPoller(RDA5807M &radio) : radio(radio) {
+            clearStats();
+            reset();
+        };
+
+        /*
+        * Description:
+        *   Starts over, looking for RDS right away. Call after tuning.
+        */
+        void reset(void);
+
+        /*
+        * Description:
+        *   Reads the chip if it's time to, call from the main loop as often
+        *   as convenient.
+        * Parameters:
+        *   group - where to put a new group.
+        *   now   - current time in microseconds, as returned by micros().
+        * Returns:
+        *   true if there was a new group.
+        */
+        bool service(TRDA5807MRDSGroup &group, unsigned long now);
+        bool service(TRDA5807MRDSGroup &group) {
+            return service(group, micros());
+        };
+
+        /*
+        * Description:
+        *   Time, in micros(), of the next read. A loop with nothing else to do
+        *   can sleep until then.
+        */
+        unsigned long getDue(void) { return due; };
+
+        /*
+        * Description:
+        *   Returns true while groups arrive on schedule.
+        */
+        bool isSynchronized(void) {
+            return state == RDA5807M_RDSPOLL_SYNCED;
+        };
+
+        /*
+        * Description:
+        *   Reads, groups read and groups lost so far, and the resulting reads
+        *   per group in hundredths (e.g. 125 for 1.25).
+        */
+        const TRDA5807MRDSPollStats &getStats(void) { return stats; };
+        word getPollsPerGroup(void) {
+            return stats.captured ? stats.polls * 100UL / stats.captured : 0;
+        };
+        void clearStats(void) { memset(&stats, 0x00, sizeof(stats)); };
+
+    private:
+        RDA5807M &radio;
+        TRDA5807MRDSPollStats stats;
+        byte state; //One of the RDA5807M_RDSPOLL_* states
+        unsigned long anchor; //When the last group is reckoned to have come
+        unsigned long lead;
+        unsigned long step; //Between reads now: backoff, or once late
+        unsigned long last; //Time of the last read
+        unsigned long due;
+        byte early; //Reads that came up empty since the last group
+};
+
+#endif
@@ -0,0 +1,204 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file contains a wait-free single producer, single consumer queue of
+ * raw RDS groups, to hand groups read in an interrupt handler or a dedicated
+ * thread over to the main loop for decoding without disabling interrupts or
+ * taking a lock. It is header-only.
+ */
+
+#ifndef _RDA5807M_RDSQUEUE_H_INCLUDED
+#define _RDA5807M_RDSQUEUE_H_INCLUDED
+
+#include "RDA5807M.h"
+
+#if !defined(ARDUINO)
+# include <atomic>
+#endif
+
+/*
+ * Queue position, written by one side only and read by the other. On
+ * Arduino a byte load or store is a single instruction, so it can't tear, and
+ * the compiler barriers keep slot accesses from moving across it (all the
+ * ordering a single core needs). On a host, std::atomic does both.
+ */
+class RDA5807MQueueIndex
+{
+    public:
+        RDA5807MQueueIndex(void) : value(0) {};
+
+#if defined(ARDUINO)
+        //The other side's position, and what it did to the slots before
+        byte acquire(void) const {
+            const byte current = value;
+
+            asm volatile("" ::: "memory");
+
+            return current;
+        };
+        //Our own position, which nobody else writes
+        byte own(void) const { return value; };
+        //Publish a new position, after what we did to the slots
+        void release(byte position) {
+            asm volatile("" ::: "memory");
+            value = position;
+        };
+
+    private:
+        volatile byte value;
+#else
+        byte acquire(void) const {
+            return value.load(std::memory_order_acquire);
+        };
+        byte own(void) const { return value.load(std::memory_order_relaxed); };
+        void release(byte position) {
+            value.store(position, std::memory_order_release);
+        };
+
+    private:
+        std::atomic<byte> value;
+#endif
+};
+
+/*
+ * Event count, bumped by one side only and read by the other. It needs no
+ * ordering, just a value that doesn't tear, which std::atomic gives on a
+ * host. On Arduino a word takes two loads, so read it with interrupts
+ * disabled if the writer is an ISR and the exact value matters.
+ */
+class RDA5807MQueueCounter
+{
+    public:
+        RDA5807MQueueCounter(void) : value(0) {};
+
+#if defined(ARDUINO)
+        word get(void) const { return value; };
+        //Writer side only
+        void increment(void) { value = value + 1; };
+
+    private:
+        volatile word value;
+#else
+        word get(void) const { return value.load(std::memory_order_relaxed); };
+        void increment(void) {
+            value.store(value.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+        };
+
+    private:
+        std::atomic<word> value;
+#endif
+};
+
+/*
+ * Fixed capacity ring of TRDA5807MRDSGroup. push() may only ever be called
+ * from one context (the producer, e.g. an ISR, the tick() RDS callback or a
+ * reader thread) and pop() from one other (the consumer, e.g. the main loop).
+ * Neither ever waits for the other: a full queue drops the newest group and
+ * counts it in getOverflows(). capacity must be a power of two, up to 128.
+ */
+template <byte capacity>
+class RDA5807MRDSQueue
+{
+    static_assert(capacity && capacity <= 128 && !(capacity & (capacity - 1)),
+                  "capacity must be a power of two up to 128");
+
+    public:
+        RDA5807MRDSQueue(void) {};
+
+        /*
+        * Description:
+        *   Producer side: appends a group.
+        * Returns:
+        *   false if the queue was full and the group was dropped.
+        */
+        bool push(const TRDA5807MRDSGroup &group) {
+            const byte position = head.own();
+
+            //Positions run free and wrap at 256, a multiple of capacity
+            if ((byte)(position - tail.acquire()) == capacity) {
+                overflows.increment();
+
+                return false;
+            };
+            slots[position & (capacity - 1)] = group;
+            head.release(position + 1);
+
+            return true;
+        };
+
+        /*
+        * Description:
+        *   Producer side: appends the RDS group in a status snapshot, if it
+        *   holds a new one (e.g. straight from the tick() RDS callback).
+        * Returns:
+        *   false if there was no group or the queue was full.
+        */
+        bool push(const TRDA5807MStatus &status, unsigned long time) {
+            TRDA5807MRDSGroup group;
+
+            if (!(status.status & RDA5807M_STATUS_RDSR))
+                return false;
+            for(byte i=0; i < 4; i++)
+                group.blocks[i] = status.rds[i];
+            group.bler = status.rssi &
+                (RDA5807M_BLERA_MASK | RDA5807M_BLERB_MASK);
+            group.time = time;
+
+            return push(group);
+        };
+
+        /*
+        * Description:
+        *   Consumer side: takes the oldest group out.
+        * Returns:
+        *   false if the queue was empty.
+        */
+        bool pop(TRDA5807MRDSGroup &group) {
+            const byte position = tail.own();
+
+            if (position == head.acquire())
+                return false;
+            group = slots[position & (capacity - 1)];
+            tail.release(position + 1);
+
+            return true;
+        };
+
+        /*
+        * Description:
+        *   Consumer side: drops everything queued, e.g. after retuning.
+        */
+        void clear(void) { tail.release(head.acquire()); };
+
+        /*
+        * Description:
+        *   Number of groups queued. The other side may change it at any
+        *   time, so it's a lower bound for the consumer (more may have come
+        *   in) and an upper bound for the producer (some may have gone).
+        */
+        byte getCount(void) const {
+            return head.acquire() - tail.acquire();
+        };
+
+        /*
+        * Description:
+        *   Number of groups dropped because the queue was full, see
+        *   RDA5807MQueueCounter.
+        */
+        word getOverflows(void) const { return overflows.get(); };
+
+    private:
+        TRDA5807MRDSGroup slots[capacity];
+        RDA5807MQueueIndex head; //Written by the producer
+        RDA5807MQueueIndex tail; //Written by the consumer
+        RDA5807MQueueCounter overflows; //Written by the producer
+};
+
+#endif
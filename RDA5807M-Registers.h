@@ -0,0 +1,219 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file contains the typed register file: the writable (0x02 to 0x08)
+ * and readable (0x0A to 0x0F) halves as plain arrays of words, plus a
+ * constexpr descriptor (register, mask, shift) for every named field in them.
+ * Unlike bitfields, this doesn't depend on how the compiler lays out structs
+ * or on host endianness, and an access through a descriptor compiles to the
+ * same mask and shift one would write by hand.
+ */
+
+#ifndef _RDA5807M_REGISTERS_H_INCLUDED
+#define _RDA5807M_REGISTERS_H_INCLUDED
+
+//One field of the register file starting at register first. Everything is in
+//the type, so accesses fold to constants no matter how late the compiler
+//inlines them, and a descriptor is only accepted by the register file it
+//belongs to.
+template <byte first, byte r, word m, byte s>
+struct TRDA5807MField
+{
+    static constexpr byte reg = r;
+    static constexpr word mask = m;
+    static constexpr byte shift = s;
+};
+
+template <byte first, byte count>
+struct TRDA5807MRegisterFile
+{
+    word regs[count]; //regs[0] is register first
+
+    /*
+    * Description:
+    *   Value of the given field, shifted down to bit 0.
+    */
+    template <byte r, word m, byte s>
+    constexpr word get(TRDA5807MField<first, r, m, s>) const {
+        return (regs[r - first] & m) >> s;
+    };
+
+    /*
+    * Description:
+    *   Sets the given field to value, which is shifted into place and
+    *   truncated to the width of the field.
+    */
+    template <byte r, word m, byte s>
+    void set(TRDA5807MField<first, r, m, s>, word value) {
+        regs[r - first] = (regs[r - first] & ~m) | ((value << s) & m);
+    };
+
+    /*
+    * Description:
+    *   Whole register access, by register address.
+    */
+    word &operator[](byte reg) { return regs[reg - first]; };
+    constexpr word operator[](byte reg) const { return regs[reg - first]; };
+};
+
+template <byte r, word m, byte s>
+using TRDA5807MWriteField = TRDA5807MField<RDA5807M_FIRST_REGISTER_WRITE, r,
+                                           m, s>;
+template <byte r, word m, byte s>
+using TRDA5807MReadField = TRDA5807MField<RDA5807M_FIRST_REGISTER_READ, r,
+                                          m, s>;
+
+//Writable register file, as sent in one sequential write
+typedef TRDA5807MRegisterFile<RDA5807M_FIRST_REGISTER_WRITE,
+                              RDA5807M_SHADOW_SIZE> TRDA5807MRegisterFileWrite;
+//Readable register file, as received in one sequential read
+typedef TRDA5807MRegisterFile<RDA5807M_FIRST_REGISTER_READ,
+                              RDA5807M_STATUS_SIZE> TRDA5807MRegisterFileRead;
+
+//Field descriptors. Masks are spelled out rather than taken from the
+//RDA5807M_*_MASK constants because word() isn't constexpr on Arduino.
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x8000, 15>
+    RDA5807M_FIELD_DHIZ = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x4000, 14>
+    RDA5807M_FIELD_DMUTE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x2000, 13>
+    RDA5807M_FIELD_MONO = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x1000, 12>
+    RDA5807M_FIELD_BASS = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0800, 11>
+    RDA5807M_FIELD_RCLKNOCAL = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0400, 10>
+    RDA5807M_FIELD_RCLKDIRECT = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0200, 9>
+    RDA5807M_FIELD_SEEKUP = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0100, 8>
+    RDA5807M_FIELD_SEEK = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0080, 7>
+    RDA5807M_FIELD_SKMODE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0070, 4>
+    RDA5807M_FIELD_CLKMODE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0008, 3>
+    RDA5807M_FIELD_RDS = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0004, 2>
+    RDA5807M_FIELD_NEW = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0002, 1>
+    RDA5807M_FIELD_RESET = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_CONFIG, 0x0001, 0>
+    RDA5807M_FIELD_ENABLE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_TUNING, 0xFFC0, 6>
+    RDA5807M_FIELD_CHAN = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_TUNING, 0x0020, 5>
+    RDA5807M_FIELD_DIRECT = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_TUNING, 0x0010, 4>
+    RDA5807M_FIELD_TUNE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_TUNING, 0x000C, 2>
+    RDA5807M_FIELD_BAND = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_TUNING, 0x0003, 0>
+    RDA5807M_FIELD_SPACE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x8000, 15>
+    RDA5807P_FIELD_RDSIEN = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x4000, 14>
+    RDA5807P_FIELD_STCIEN = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x0800, 11>
+    RDA5807M_FIELD_DE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x0200, 9>
+    RDA5807M_FIELD_SOFTMUTE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x0100, 8>
+    RDA5807M_FIELD_AFCD = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x0040, 6>
+    RDA5807P_FIELD_I2S = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x0030, 4>
+    RDA5807P_FIELD_GPIO3 = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x000C, 2>
+    RDA5807P_FIELD_GPIO2 = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_GPIO, 0x0003, 0>
+    RDA5807P_FIELD_GPIO1 = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_VOLUME, 0x8000, 15>
+    RDA5807P_FIELD_INTMODE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_VOLUME, 0x7F00, 8>
+    RDA5807M_FIELD_SEEKTH = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_VOLUME, 0x00C0, 6>
+    RDA5807P_FIELD_LNAP = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_VOLUME, 0x0030, 4>
+    RDA5807P_FIELD_LNAI = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_VOLUME, 0x00F0, 4>
+    RDA5800_FIELD_VOLUMEDSP = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_VOLUME, 0x000F, 0>
+    RDA5807M_FIELD_VOLUME = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x6000, 13>
+    RDA5807M_FIELD_OPENMODE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x1000, 12>
+    RDA5807P_FIELD_I2SSLAVE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0800, 11>
+    RDA5807P_FIELD_SWLR = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0400, 10>
+    RDA5807P_FIELD_SCLKINVERT_I = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0200, 9>
+    RDA5807P_FIELD_SIGNED = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0100, 8>
+    RDA5807P_FIELD_WSINVERT_I = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x00F0, 4>
+    RDA5807P_FIELD_I2SRATE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0008, 3>
+    RDA5807P_FIELD_WSINVERT_O = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0004, 2>
+    RDA5807P_FIELD_SCLKINVERT_O = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0002, 1>
+    RDA5807P_FIELD_DELAY_L = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_I2S, 0x0001, 0>
+    RDA5807P_FIELD_DELAY_R = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_BLEND, 0x7C00, 10>
+    RDA5807M_FIELD_SOFTBLENDTH = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_BLEND, 0x0200, 9>
+    RDA5807M_FIELD_EASTBAND65M = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_BLEND, 0x00FC, 2>
+    RDA5807M_FIELD_SEEKTHOLD = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_BLEND, 0x0002, 1>
+    RDA5807M_FIELD_SOFTBLEND = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_BLEND, 0x0001, 0>
+    RDA5807M_FIELD_FREQMODE = {};
+constexpr TRDA5807MWriteField<RDA5807M_REG_FREQ, 0xFFFF, 0>
+    RDA5807M_FIELD_FREQ = {};
+
+constexpr TRDA5807MReadField<RDA5807M_REG_STATUS, 0x8000, 15>
+    RDA5807M_FIELD_RDSR = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_STATUS, 0x4000, 14>
+    RDA5807M_FIELD_STC = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_STATUS, 0x2000, 13>
+    RDA5807M_FIELD_SF = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_STATUS, 0x1000, 12>
+    RDA5807M_FIELD_RDSS = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_STATUS, 0x0800, 11>
+    RDA5807M_FIELD_BLKE = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_STATUS, 0x0400, 10>
+    RDA5807M_FIELD_ST = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_STATUS, 0x03FF, 0>
+    RDA5807M_FIELD_READCHAN = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RSSI, 0xFE00, 9>
+    RDA5807M_FIELD_RSSI = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RSSI, 0x0100, 8>
+    RDA5807M_FIELD_FMTRUE = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RSSI, 0x0080, 7>
+    RDA5807M_FIELD_FMREADY = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RSSI, 0x0010, 4>
+    RDA5807M_FIELD_BLOCKE = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RSSI, 0x000C, 2>
+    RDA5807M_FIELD_BLERA = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RSSI, 0x0003, 0>
+    RDA5807M_FIELD_BLERB = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RDSA, 0xFFFF, 0>
+    RDA5807M_FIELD_RDSA = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RDSB, 0xFFFF, 0>
+    RDA5807M_FIELD_RDSB = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RDSC, 0xFFFF, 0>
+    RDA5807M_FIELD_RDSC = {};
+constexpr TRDA5807MReadField<RDA5807M_REG_RDSD, 0xFFFF, 0>
+    RDA5807M_FIELD_RDSD = {};
+
+#endif
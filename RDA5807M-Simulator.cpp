@@ -0,0 +1,475 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the register-level chip simulator. It compiles to
+ * nothing on Arduino.
+ * See the header file for better function documentation.
+ */
+
+#if !defined(ARDUINO)
+
+#include "RDA5807M.h"
+#include "RDA5807M-private.h"
+#include "RDA5807M-Simulator.h"
+
+//Operation in progress
+#define SIM_IDLE 0
+#define SIM_TUNE 1
+#define SIM_SEEK 2
+
+//Each thread runs its own simulated world
+static thread_local unsigned long simulatedMicros = 0;
+static thread_local RDA5807MSimulator *chips = NULL;
+
+RDA5807MSimulator::RDA5807MSimulator(void) : stationCount(0), irqHandler(NULL),
+                                             irqContext(NULL),
+                                             busSpeed(400000UL), mux(NULL),
+                                             muxChannel(0) {
+    clearStats();
+    reset();
+    nextChip = chips;
+    chips = this;
+};
+
+RDA5807MSimulator::~RDA5807MSimulator() {
+    for(RDA5807MSimulator **chip = &chips; *chip; chip = &(*chip)->nextChip)
+        if (*chip == this) {
+            *chip = nextChip;
+            break;
+        };
+};
+
+void RDA5807MSimulator::reset(void) {
+    memset(regs, 0x00, sizeof(regs));
+    //Power-on defaults, as per the datasheet
+    regs[RDA5807M_REG_CHIPID] = 0x5804;
+    regs[RDA5807M_REG_VOLUME] = 0x888B;
+    regs[RDA5807M_REG_BLEND] = 0x4202;
+    pointer = 0;
+    midTransaction = false;
+    groupHead = groupTail = 0;
+    operation = SIM_IDLE;
+    channel = 0;
+    groupCount = psSegment = 0;
+    nextGroup = now() + RDA5807M_SIM_GROUP_US;
+};
+
+TRDA5807MSimStation *RDA5807MSimulator::addStation(word frequency, byte rssi,
+                                                   bool stereo, word pi,
+                                                   const char *ps) {
+    if (stationCount == RDA5807M_SIM_STATIONS)
+        return NULL;
+
+    TRDA5807MSimStation &station = stations[stationCount++];
+
+    station.frequency = frequency;
+    station.rssi = rssi;
+    station.stereo = stereo;
+    station.pi = pi;
+    memset(station.ps, ' ', sizeof(station.ps));
+    if (ps)
+        memcpy(station.ps, ps, strnlen(ps, sizeof(station.ps)));
+    station.afCount = 0;
+
+    return &station;
+};
+
+bool RDA5807MSimulator::injectGroup(const word blocks[4], byte bler) {
+    const byte next = (groupTail + 1) % RDA5807M_SIM_GROUPS;
+
+    if (next == groupHead)
+        return false;
+
+    memcpy(groups[groupTail], blocks, 4 * sizeof(word));
+    groups[groupTail][4] = bler;
+    groupTail = next;
+
+    return true;
+};
+
+word RDA5807MSimulator::frequencyOf(word chan) {
+    const byte band = RDA5807MBandIndex(regs[RDA5807M_REG_TUNING],
+                                        regs[RDA5807M_REG_BLEND]);
+
+    if (regs[RDA5807M_REG_BLEND] & RDA5807M_FLG_FREQMODE)
+        return RDA5807MDirectFrequency(band, regs[RDA5807M_REG_FREQ]);
+
+    return RDA5807MChannelFrequency(band, regs[RDA5807M_REG_TUNING] &
+                                    RDA5807M_SPACE_MASK, chan);
+};
+
+word RDA5807MSimulator::channelCount(void) {
+    return RDA5807MLastChannel(RDA5807MBandIndex(regs[RDA5807M_REG_TUNING],
+                                                 regs[RDA5807M_REG_BLEND]),
+                               regs[RDA5807M_REG_TUNING] &
+                               RDA5807M_SPACE_MASK) + 1;
+};
+
+const TRDA5807MSimStation *RDA5807MSimulator::stationAt(word frequency) {
+    const TRDA5807MSimStation *result = NULL;
+    word best = RDA5807M_SIM_CAPTURE + 1;
+
+    for(byte i=0; i < stationCount; i++) {
+        const word offset = frequency > stations[i].frequency ?
+            frequency - stations[i].frequency :
+            stations[i].frequency - frequency;
+
+        if (offset < best) {
+            best = offset;
+            result = &stations[i];
+        };
+    };
+
+    return result;
+};
+
+byte RDA5807MSimulator::rssiAt(word frequency) {
+    int result = RDA5807M_SIM_NOISE_RSSI;
+
+    for(byte i=0; i < stationCount; i++) {
+        const int offset = frequency > stations[i].frequency ?
+            frequency - stations[i].frequency :
+            stations[i].frequency - frequency;
+        const int rssi = stations[i].rssi - offset * RDA5807M_SIM_FALLOFF;
+
+        if (rssi > result)
+            result = rssi;
+    };
+
+    return result > 0x7F ? 0x7F : result;
+};
+
+bool RDA5807MSimulator::isStation(word frequency) {
+    return stationAt(frequency) &&
+        rssiAt(frequency) >= ((regs[RDA5807M_REG_VOLUME] &
+                               RDA5807M_SEEKTH_MASK) >> RDA5807M_SEEKTH_SHIFT);
+};
+
+word RDA5807MSimulator::getFrequency(void) {
+    return frequencyOf(channel);
+};
+
+word RDA5807MSimulator::getRegister(byte reg) {
+    const word frequency = getFrequency();
+    const TRDA5807MSimStation *station = stationAt(frequency);
+
+    switch (reg) {
+        case RDA5807M_REG_STATUS: {
+            word value = (regs[RDA5807M_REG_STATUS] &
+                          (RDA5807M_STATUS_RDSR | RDA5807M_STATUS_STC |
+                           RDA5807M_STATUS_SF | RDA5807M_STATUS_RDSS)) |
+                (channel & RDA5807M_READCHAN_MASK);
+
+            if (operation == SIM_IDLE && station && station->stereo &&
+                rssiAt(frequency) >= RDA5807M_SIM_STEREO_RSSI &&
+                !(regs[RDA5807M_REG_CONFIG] & RDA5807M_FLG_MONO))
+                value |= RDA5807M_STATUS_ST;
+
+            return value;
+        };
+        case RDA5807M_REG_RSSI:
+            return ((word)rssiAt(frequency) << RDA5807M_RSSI_SHIFT) |
+                (isStation(frequency) ? RDA5807M_FLG_FMTRUE : 0x00) |
+                RDA5807M_FLG_FMREADY |
+                (regs[RDA5807M_REG_RSSI] & (RDA5807M_BLERA_MASK |
+                                            RDA5807M_BLERB_MASK));
+        default:
+            return reg <= RDA5807M_LAST_REGISTER ? regs[reg] : 0xFFFF;
+    };
+};
+
+void RDA5807MSimulator::interrupt(word enable) {
+    const word gpio = regs[RDA5807M_REG_GPIO];
+
+    if ((gpio & RDA5807P_GPIO2_MASK) == RDA5807P_GPIO2_INT &&
+        (gpio & enable) && irqHandler)
+        irqHandler(irqContext);
+};
+
+void RDA5807MSimulator::startTune(bool seek) {
+    regs[RDA5807M_REG_STATUS] &= ~(RDA5807M_STATUS_STC | RDA5807M_STATUS_SF |
+                                   RDA5807M_STATUS_RDSR |
+                                   RDA5807M_STATUS_RDSS);
+    operation = seek ? SIM_SEEK : SIM_TUNE;
+    operationEnd = now() + RDA5807M_SIM_TUNE_US;
+    if (!seek)
+        return;
+
+    //The RF environment is static, so work out where the seek ends up now
+    const bool up = regs[RDA5807M_REG_CONFIG] & RDA5807M_FLG_SEEKUP;
+    const bool wrap = !(regs[RDA5807M_REG_CONFIG] & RDA5807M_FLG_SKMODE);
+    const word last = channelCount() - 1;
+    word chan = channel;
+
+    for(word step = 1; step <= last + 1; step++) {
+        if (up && chan == last) {
+            if (!wrap)
+                break;
+            chan = 0;
+        } else if (!up && chan == 0) {
+            if (!wrap)
+                break;
+            chan = last;
+        } else
+            chan += up ? 1 : -1;
+        operationEnd += RDA5807M_SIM_SEEK_STEP_US;
+        if (chan != channel && isStation(frequencyOf(chan))) {
+            seekTarget = chan;
+            seekFailed = false;
+
+            return;
+        };
+    };
+    seekTarget = chan;
+    seekFailed = true;
+};
+
+void RDA5807MSimulator::finishOperation(void) {
+    if (operation == SIM_SEEK) {
+        channel = seekTarget;
+        regs[RDA5807M_REG_CONFIG] &= ~RDA5807M_FLG_SEEK;
+        if (seekFailed)
+            regs[RDA5807M_REG_STATUS] |= RDA5807M_STATUS_SF;
+    } else {
+        channel = regs[RDA5807M_REG_TUNING] >> RDA5807M_CHAN_SHIFT;
+        regs[RDA5807M_REG_TUNING] &= ~RDA5807M_FLG_TUNE;
+    };
+    regs[RDA5807M_REG_STATUS] |= RDA5807M_STATUS_STC;
+    groupCount = psSegment = 0;
+    nextGroup = operationEnd + RDA5807M_SIM_GROUP_US;
+    operation = SIM_IDLE;
+    interrupt(RDA5807P_FLG_STCIEN);
+};
+
+void RDA5807MSimulator::deliverGroup(void) {
+    word *group = &regs[RDA5807M_REG_RDSA];
+    const TRDA5807MSimStation *station = stationAt(getFrequency());
+    const bool injected = (groupHead != groupTail);
+
+    if (!injected && (!station || !station->pi))
+        return;
+
+    //The chip's RDS decoder needs a few groups to lock on
+    if (groupCount < RDA5807M_SIM_SYNC_GROUPS) {
+        groupCount++;
+
+        return;
+    };
+
+    regs[RDA5807M_REG_RSSI] &= ~(RDA5807M_BLERA_MASK | RDA5807M_BLERB_MASK);
+    if (injected) {
+        memcpy(group, groups[groupHead], 4 * sizeof(word));
+        regs[RDA5807M_REG_RSSI] |= groups[groupHead][4] &
+            (RDA5807M_BLERA_MASK | RDA5807M_BLERB_MASK);
+        groupHead = (groupHead + 1) % RDA5807M_SIM_GROUPS;
+    } else {
+        //Type 0A: PS two characters at a time and the AF list (method A)
+        byte codes[RDA5807M_SIM_AF_MAX + 2];
+        byte count = 0;
+
+        codes[count++] = 224 + station->afCount;
+        for(byte i=0; i < station->afCount; i++)
+            codes[count++] = station->af[i];
+        if (count & 0x01)
+            codes[count++] = 205;
+
+        const byte pair = (groupCount - RDA5807M_SIM_SYNC_GROUPS) %
+            (count / 2);
+
+        group[0] = station->pi;
+        group[1] = psSegment;
+        group[2] = word(codes[pair * 2], codes[pair * 2 + 1]);
+        group[3] = word(station->ps[psSegment * 2],
+                        station->ps[psSegment * 2 + 1]);
+        psSegment = (psSegment + 1) & 0x03;
+        //Once locked on, stay locked on rather than again every 256 groups
+        if (++groupCount == 0)
+            groupCount = RDA5807M_SIM_SYNC_GROUPS;
+    };
+    regs[RDA5807M_REG_STATUS] |= RDA5807M_STATUS_RDSR | RDA5807M_STATUS_RDSS;
+    interrupt(RDA5807P_FLG_RDSIEN);
+};
+
+void RDA5807MSimulator::update(void) {
+    const unsigned long t = now();
+
+    if (operation != SIM_IDLE && (long)(t - operationEnd) >= 0)
+        finishOperation();
+
+    if (operation != SIM_IDLE ||
+        !(regs[RDA5807M_REG_CONFIG] & RDA5807M_FLG_ENABLE) ||
+        !(regs[RDA5807M_REG_CONFIG] & RDA5807M_FLG_RDS)) {
+        nextGroup = t + RDA5807M_SIM_GROUP_US;
+
+        return;
+    };
+
+    while ((long)(t - nextGroup) >= 0) {
+        deliverGroup();
+        nextGroup += RDA5807M_SIM_GROUP_US;
+    };
+};
+
+void RDA5807MSimulator::written(word touched) {
+    const word config = regs[RDA5807M_REG_CONFIG];
+
+    if (config & RDA5807M_FLG_RESET) {
+        reset();
+
+        return;
+    };
+    if (!(config & RDA5807M_FLG_ENABLE)) {
+        operation = SIM_IDLE;
+
+        return;
+    };
+
+    if (config & RDA5807M_FLG_SEEK) {
+        if (operation != SIM_SEEK)
+            startTune(true);
+    } else if (operation == SIM_SEEK) {
+        //Clearing SEEK aborts the seek where it stands
+        operation = SIM_IDLE;
+        regs[RDA5807M_REG_STATUS] |= RDA5807M_STATUS_STC | RDA5807M_STATUS_SF;
+    } else if ((touched & (1 << RDA5807M_REG_TUNING)) &&
+               (regs[RDA5807M_REG_TUNING] & RDA5807M_FLG_TUNE))
+        startTune(false);
+};
+
+void RDA5807MSimulator::account(byte count, bool stop) {
+    //Start (or repeated start), address and data bytes with their ACKs and,
+    //if this ends the transaction, stop
+    const unsigned long bits = 1 + (count + 1) * 9 + (stop ? 1 : 0);
+
+    if (!midTransaction)
+        stats.transactions++;
+    midTransaction = !stop;
+    stats.bytes += count + 1;
+    stats.bits += bits;
+    advance((bits * 1000000UL + busSpeed - 1) / busSpeed);
+};
+
+//Whether the chip is out of reach, behind a multiplexer channel that isn't
+//selected
+#define SIM_UNREACHABLE (mux && !(mux->getSelected() & (1 << muxChannel)))
+
+byte RDA5807MSimulator::write(byte address, const byte data[], byte count,
+                              bool stop) {
+    if (mux && address == mux->getAddress())
+        return mux->write(data, count, stop);
+
+    update();
+    account(count, stop);
+    if ((address != RDA5807M_I2C_ADDR_SEQRDA &&
+         address != RDA5807M_I2C_ADDR_RANDOM) || SIM_UNREACHABLE) {
+        stats.nacks++;
+
+        return 2;
+    };
+
+    byte reg = RDA5807M_FIRST_REGISTER_WRITE, i = 0;
+    word touched = 0x0000;
+
+    if (address == RDA5807M_I2C_ADDR_RANDOM) {
+        if (!count)
+            return 0;
+        reg = pointer = data[0];
+        i = 1;
+    };
+    for(; i + 1 < count && reg <= RDA5807M_LAST_REGISTER; i += 2, reg++) {
+        //Chip ID and the status registers are read-only
+        if (reg == RDA5807M_REG_CHIPID ||
+            (reg >= RDA5807M_REG_STATUS && reg <= RDA5807M_REG_RDSD))
+            continue;
+        regs[reg] = word(data[i], data[i + 1]);
+        if (reg <= RDA5807M_REG_FREQ)
+            touched |= 1 << reg;
+    };
+    if (touched)
+        written(touched);
+
+    return 0;
+};
+
+byte RDA5807MSimulator::read(byte address, byte data[], byte count,
+                             bool stop) {
+    if (mux && address == mux->getAddress())
+        return mux->read(data, count, stop);
+
+    update();
+    account(count, stop);
+    if ((address != RDA5807M_I2C_ADDR_SEQRDA &&
+         address != RDA5807M_I2C_ADDR_RANDOM) || SIM_UNREACHABLE) {
+        stats.nacks++;
+
+        return 0;
+    };
+
+    byte reg = (address == RDA5807M_I2C_ADDR_RANDOM) ? pointer :
+        RDA5807M_FIRST_REGISTER_READ;
+    bool rdsRead = false;
+
+    for(byte i=0; i + 1 < count; i += 2, reg++) {
+        const word value = getRegister(reg);
+
+        data[i] = highByte(value);
+        data[i + 1] = lowByte(value);
+        if (reg == RDA5807M_REG_RDSA)
+            rdsRead = true;
+    };
+    //Reading RDSA is what acknowledges the group (and releases GPIO2)
+    if (rdsRead)
+        regs[RDA5807M_REG_STATUS] &= ~RDA5807M_STATUS_RDSR;
+
+    return count;
+};
+
+void RDA5807MSimulatorMux::account(byte count, bool stop) {
+    const unsigned long bits = 1 + (count + 1) * 9 + (stop ? 1 : 0);
+
+    stats.transactions++;
+    stats.bytes += count + 1;
+    stats.bits += bits;
+    //Always at 400kHz
+    RDA5807MSimulator::advance((bits * 1000000UL + 399999UL) / 400000UL);
+};
+
+byte RDA5807MSimulatorMux::write(const byte data[], byte count, bool stop) {
+    account(count, stop);
+    //The last byte written wins, like on the real thing
+    if (count)
+        selected = data[count - 1];
+
+    return 0;
+};
+
+byte RDA5807MSimulatorMux::read(byte data[], byte count, bool stop) {
+    account(count, stop);
+    for(byte i=0; i < count; i++)
+        data[i] = selected;
+
+    return count;
+};
+
+void RDA5807MSimulator::installClock(void) {
+    RDA5807MHostMicros = now;
+    RDA5807MHostSleep = advance;
+};
+
+unsigned long RDA5807MSimulator::now(void) {
+    return simulatedMicros;
+};
+
+void RDA5807MSimulator::advance(unsigned long us) {
+    simulatedMicros += us;
+    for(RDA5807MSimulator *chip = chips; chip; chip = chip->nextChip)
+        chip->update();
+};
+
+#endif
@@ -0,0 +1,313 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the include file for the register-level chip simulator, used to
+ * run and benchmark the driver on a host without a radio. Selecting
+ * RDA5807M_BUS_SIMULATOR at compile time also makes it the bus backend.
+ */
+
+#ifndef _RDA5807M_SIMULATOR_H_INCLUDED
+#define _RDA5807M_SIMULATOR_H_INCLUDED
+
+//Simulated chip timing, in microseconds of simulated time
+#define RDA5807M_SIM_TUNE_US 6000UL
+#define RDA5807M_SIM_SEEK_STEP_US 8000UL
+#define RDA5807M_SIM_GROUP_US 87600UL
+#define RDA5807M_SIM_SYNC_GROUPS 2
+
+//Simulated RF environment: RSSI floor, RSSI lost per 10kHz of detuning, how
+//far off a station still counts as tuned to it (in 10kHz units) and the RSSI
+//needed for stereo.
+#define RDA5807M_SIM_NOISE_RSSI 6
+#define RDA5807M_SIM_FALLOFF 2
+#define RDA5807M_SIM_CAPTURE 5
+#define RDA5807M_SIM_STEREO_RSSI 20
+
+//Capacities
+#define RDA5807M_SIM_STATIONS 64
+#define RDA5807M_SIM_GROUPS 64
+#define RDA5807M_SIM_AF_MAX 8
+
+//One station of the simulated band plan.
+typedef struct {
+    word frequency; //In 10kHz units
+    byte rssi;
+    bool stereo;
+    word pi; //0 for no RDS
+    char ps[8];
+    byte afCount;
+    byte af[RDA5807M_SIM_AF_MAX]; //RDS AF codes
+} TRDA5807MSimStation;
+
+//Bus traffic seen by the simulated chip.
+typedef struct {
+    unsigned long transactions; //Start to stop, repeated starts included
+    unsigned long bytes; //Address bytes included
+    unsigned long bits; //Start, stop and ACK bits included
+    unsigned long nacks;
+} TRDA5807MSimStats;
+
+/*
+ * A TCA9548A-style I2C multiplexer in front of simulated chips, see
+ * RDA5807MSimulator::setMux(). Writing a byte to it selects the downstream
+ * channels whose bits are set, reading it returns that selection.
+ */
+class RDA5807MSimulatorMux
+{
+    public:
+        RDA5807MSimulatorMux(byte address) : address(address), selected(0x00) {
+            clearStats();
+        };
+
+        byte getAddress(void) { return address; };
+        byte getSelected(void) { return selected; };
+
+        /*
+        * Description:
+        *   Bus traffic addressed to the multiplexer itself.
+        */
+        const TRDA5807MSimStats &getStats(void) { return stats; };
+        void clearStats(void) { memset(&stats, 0x00, sizeof(stats)); };
+
+        /*
+        * Description:
+        *   As for RDA5807MSimulator, minus the address.
+        */
+        byte write(const byte data[], byte count, bool stop);
+        byte read(byte data[], byte count, bool stop);
+
+    private:
+        byte address;
+        byte selected;
+        TRDA5807MSimStats stats;
+
+        void account(byte count, bool stop);
+};
+
+class RDA5807MSimulator
+{
+    public:
+        /*
+        * Description:
+        *   This is the constructor, it powers up the chip with an empty band
+        *   plan.
+        */
+        RDA5807MSimulator(void);
+        ~RDA5807MSimulator();
+
+        /*
+        * Description:
+        *   Brings the register file back to power-on defaults.
+        */
+        void reset(void);
+
+        /*
+        * Description:
+        *   Sets the contents of RDA5807M_REG_CHIPID, to pose as another
+        *   member of the family.
+        */
+        void setChipID(word id) { regs[RDA5807M_REG_CHIPID] = id; };
+
+        /*
+        * Description:
+        *   Puts the chip behind a multiplexer: it only answers while channel
+        *   is selected and passes traffic for the multiplexer's address on to
+        *   it, so any chip downstream can be used to switch it.
+        * Parameters:
+        *   mux     - the multiplexer, NULL to connect the chip directly.
+        *   channel - downstream channel, 0 to 7.
+        */
+        void setMux(RDA5807MSimulatorMux *mux, byte channel) {
+            this->mux = mux;
+            muxChannel = channel;
+        };
+
+        /*
+        * Description:
+        *   Adds a station to the band plan. Stations with a non-zero PI
+        *   broadcast type 0A groups carrying their PS and AF list.
+        * Parameters:
+        *   frequency - in 10kHz units.
+        *   rssi      - RSSI when tuned exactly, 0 to 127.
+        *   stereo    - whether the station broadcasts in stereo.
+        *   pi        - RDS Programme Identification, 0 for no RDS.
+        *   ps        - RDS Programme Service name, up to 8 characters.
+        * Returns:
+        *   pointer to the new entry (e.g. to fill in its AF list) or NULL if
+        *   the band plan is full.
+        */
+        TRDA5807MSimStation *addStation(word frequency, byte rssi,
+                                        bool stereo = true, word pi = 0,
+                                        const char *ps = NULL);
+        void clearStations(void) { stationCount = 0; };
+
+        /*
+        * Description:
+        *   Queues an RDS group for delivery, taking precedence over whatever
+        *   the tuned station broadcasts. Groups come out at the RDS group
+        *   rate while RDS is enabled.
+        * Parameters:
+        *   blocks - the four blocks of the group, A through D.
+        *   bler   - BLERA and BLERB as they would appear in
+        *            RDA5807M_REG_RSSI.
+        * Returns:
+        *   false if the queue is full.
+        */
+        bool injectGroup(const word blocks[4], byte bler = 0x00);
+
+        /*
+        * Description:
+        *   Sets the function called whenever GPIO2 would go active, provided
+        *   the driver has configured it as an interrupt output.
+        */
+        void setInterruptHandler(void (*handler)(void *context),
+                                 void *context) {
+            irqHandler = handler;
+            irqContext = context;
+        };
+
+        /*
+        * Description:
+        *   Sets the bus clock, used to advance simulated time by the duration
+        *   of every transaction. Defaults to 400kHz.
+        */
+        void setBusSpeed(unsigned long hz) { busSpeed = hz; };
+
+        /*
+        * Description:
+        *   Bus traffic statistics and the time it would take on the wire at
+        *   the given bus clock (e.g. 100000 or 400000).
+        */
+        const TRDA5807MSimStats &getStats(void) { return stats; };
+        void clearStats(void) { memset(&stats, 0x00, sizeof(stats)); };
+        unsigned long getBusMicros(unsigned long hz) {
+            return (unsigned long)((unsigned long long)stats.bits * 1000000UL /
+                                   hz);
+        };
+
+        /*
+        * Description:
+        *   Peeks at the register file and tuned frequency without any of the
+        *   side effects a bus access would have.
+        */
+        word getRegister(byte reg);
+        word getFrequency(void);
+
+        /*
+        * Description:
+        *   One I2C write or read phase addressed to the chip, as issued by a
+        *   bus backend. With stop set to false the transaction continues
+        *   with a repeated start.
+        * Returns:
+        *   write: 0 on success, 2 (TwoWire's address NACK) if the address
+        *   isn't one the chip answers to. read: number of bytes read.
+        */
+        byte write(byte address, const byte data[], byte count, bool stop);
+        byte read(byte address, byte data[], byte count, bool stop);
+
+        /*
+        * Description:
+        *   Simulated time, in microseconds. installClock() makes millis(),
+        *   micros() and delay() use it so the driver runs in simulated time,
+        *   and advance() moves it forward, running every simulated chip
+        *   created by the calling thread up to the new time. Each thread has
+        *   its own clock.
+        */
+        static void installClock(void);
+        static unsigned long now(void);
+        static void advance(unsigned long us);
+
+    private:
+        word regs[RDA5807M_LAST_REGISTER + 1];
+        byte pointer;
+        bool midTransaction;
+        TRDA5807MSimStation stations[RDA5807M_SIM_STATIONS];
+        byte stationCount;
+        word groups[RDA5807M_SIM_GROUPS][5];
+        byte groupHead, groupTail;
+        byte operation;
+        unsigned long operationEnd, nextGroup;
+        word channel, seekTarget;
+        bool seekFailed;
+        byte groupCount, psSegment;
+        void (*irqHandler)(void *context);
+        void *irqContext;
+        unsigned long busSpeed;
+        TRDA5807MSimStats stats;
+        RDA5807MSimulator *nextChip;
+        RDA5807MSimulatorMux *mux;
+        byte muxChannel;
+
+        void update(void);
+        void account(byte count, bool stop);
+        void written(word touched);
+        void startTune(bool seek);
+        void finishOperation(void);
+        void deliverGroup(void);
+        void interrupt(word enable);
+        word frequencyOf(word chan);
+        word channelCount(void);
+        const TRDA5807MSimStation *stationAt(word frequency);
+        byte rssiAt(word frequency);
+        bool isStation(word frequency);
+};
+
+#if defined(RDA5807M_BUS_SIMULATOR)
+/*
+ * Same interface as the Wire backend (see RDA5807M-Wire.h), talking to an
+ * RDA5807MSimulator attached with attach() instead of a real bus.
+ */
+class RDA5807MBus
+{
+    public:
+        RDA5807MBus(void) : chip(NULL), used(0), available(0), received(0) {};
+
+        /*
+        * Description:
+        *   Connects this bus to the given simulated chip.
+        */
+        void attach(RDA5807MSimulator &chip) { this->chip = &chip; };
+        RDA5807MSimulator *getChip(void) { return chip; };
+
+        void begin(void) {};
+        void beginTransmission(byte address) {
+            this->address = address;
+            used = 0;
+        };
+        void write(byte value) {
+            if (used < sizeof(txBuffer))
+                txBuffer[used++] = value;
+        };
+        byte endTransmission(bool stop) {
+            return chip ? chip->write(address, txBuffer, used, stop) : 2;
+        };
+        byte requestFrom(byte address, byte count, bool stop) {
+            if (count > sizeof(rxBuffer))
+                count = sizeof(rxBuffer);
+            available = chip ? chip->read(address, rxBuffer, count, stop) : 0;
+            received = 0;
+
+            return available;
+        };
+        byte read(void) {
+            return received < available ? rxBuffer[received++] : 0xFF;
+        };
+        void beginMessageSet(void) {};
+        byte endMessageSet(void) { return 0; };
+
+    private:
+        RDA5807MSimulator *chip;
+        byte address;
+        byte txBuffer[128];
+        byte rxBuffer[128];
+        byte used, available, received;
+};
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+/* Arduino RDA5807M Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/RDA5807M/blob/master/README
+ *
+ * This library is for interfacing with a RDA Microelectronics RDA5807M
+ * single-chip FM broadcast radio receiver.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file contains the Arduino Wire bus backend, used unless another one
+ * is selected at compile time (see RDA5807M.h).
+ */
+
+#ifndef _RDA5807M_WIRE_H_INCLUDED
+#define _RDA5807M_WIRE_H_INCLUDED
+
+#include <Wire.h>
+
+/*
+ * Every bus backend provides a class called RDA5807MBus with the interface
+ * below, modelled on TwoWire's. The driver holds one by value and calls it
+ * directly, so there is no virtual dispatch and, for this backend, every call
+ * inlines to exactly what the driver used to do with Wire itself.
+ */
+class RDA5807MBus
+{
+    public:
+        /*
+        * Description:
+        *   Initializes the bus hardware.
+        */
+        void begin(void) { Wire.begin(); };
+
+        /*
+        * Description:
+        *   Starts queueing a write transaction to the given slave.
+        */
+        void beginTransmission(byte address) {
+            Wire.beginTransmission(address);
+        };
+
+        /*
+        * Description:
+        *   Queues one byte for the current write transaction.
+        */
+        void write(byte value) { Wire.write(value); };
+
+        /*
+        * Description:
+        *   Sends the queued write transaction. With stop set to false the bus
+        *   is held and the next requestFrom() issues a repeated start.
+        * Returns:
+        *   0 on success, non-zero (TwoWire error codes) on NACK or failure.
+        */
+        byte endTransmission(bool stop) { return Wire.endTransmission(stop); };
+
+        /*
+        * Description:
+        *   Reads count bytes from the given slave into the receive buffer.
+        * Returns:
+        *   number of bytes actually read.
+        */
+        byte requestFrom(byte address, byte count, bool stop) {
+            return Wire.requestFrom(address, (size_t)count, stop);
+        };
+
+        /*
+        * Description:
+        *   Returns the next byte from the receive buffer.
+        */
+        byte read(void) { return Wire.read(); };
+
+        /*
+        * Description:
+        *   Hints that the write transactions in between may be submitted
+        *   together. Wire has no such thing, so these do nothing here.
+        * Returns:
+        *   0 on success, non-zero if any held back transaction failed.
+        */
+        void beginMessageSet(void) {};
+        byte endMessageSet(void) { return 0; };
+};
+
+#endif
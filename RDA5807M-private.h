@@ -19,4 +19,23 @@
 #define RDA5807M_I2C_ADDR_RANDOM (0x22 >> 1)
 #define RDA5807M_I2C_ADDR_SEQTEA (0xC0 >> 1)
 
+//Tuning engine pacing, in milliseconds. A tune settles in well under 10ms, a
+//seek spends roughly that on every channel it passes (so up to a couple of
+//seconds for a full band at 25kHz spacing).
+#define RDA5807M_TUNE_SETTLE_MS 10
+#define RDA5807M_TUNE_POLL_MS 5
+#define RDA5807M_TUNE_TIMEOUT_MS 100
+#define RDA5807M_SEEK_SETTLE_MS 50
+#define RDA5807M_SEEK_POLL_MS 25
+#define RDA5807M_SEEK_TIMEOUT_MS 5000
+
+//Scan engine pacing, in milliseconds, and the span (in 10kHz units) within
+//which neighbouring hits are considered adjacent channel spill of the same
+//station.
+#define RDA5807M_SCAN_DWELL_MS 8
+#define RDA5807M_SCAN_POLL_MS 2
+#define RDA5807M_SCAN_PI_POLL_MS 20
+#define RDA5807M_SCAN_PI_TIMEOUT_MS 1000
+#define RDA5807M_SCAN_MERGE_SPAN 15
+
 #endif
\ No newline at end of file
@@ -14,87 +14,308 @@
 #include "RDA5807M.h"
 #include "RDA5807M-private.h"
 
-#include <Wire.h>
+//Bits the chip clears on its own, these never make it into the shadow copy or
+//every subsequent read-modify-write would restart a seek or tune.
+static word selfClearingBits(byte reg) {
+    switch (reg) {
+        case RDA5807M_REG_CONFIG:
+            return RDA5807M_FLG_SEEK;
+        case RDA5807M_REG_TUNING:
+            return RDA5807M_FLG_TUNE;
+        default:
+            return 0x00;
+    };
+};
+
+static bool isShadowed(byte reg) {
+    return reg >= RDA5807M_FIRST_REGISTER_WRITE &&
+        reg < RDA5807M_FIRST_REGISTER_WRITE + RDA5807M_SHADOW_SIZE;
+};
 
 void RDA5807M::begin(byte band) {
-    Wire.begin();
+    RDA5807M_OP(BEGIN);
+    bus.begin();
     setRegister(RDA5807M_REG_CONFIG, RDA5807M_FLG_DHIZ | RDA5807M_FLG_DMUTE | 
                 RDA5807M_FLG_BASS | RDA5807M_FLG_SEEKUP | RDA5807M_FLG_RDS | 
                 RDA5807M_FLG_NEW | RDA5807M_FLG_ENABLE);
-    updateRegister(RDA5807M_REG_TUNING, RDA5807M_BAND_MASK, band);
+    //ChipID and the shadow copy in one go, register 0x01 comes along for free
+    readShadow(RDA5807M_REG_CHIPID);
+    setBand(band);
+};
+
+void RDA5807M::begin(const TRDA5807MRegisterFileWrite &image) {
+    RDA5807M_OP(BEGIN);
+    bus.begin();
+    identify(getRegister(RDA5807M_REG_CHIPID));
+    powerUp(image.regs);
+};
+
+void RDA5807M::identify(word id) {
+    chipID = id;
+    stereoMask = RDA5807M_STATUS_ST;
+
+    if (highByte(id) != RDA5807M_CHIPID)
+        //Nothing there or not one of ours, don't waste bus writes on it
+        capabilities = 0x00;
+    else if (id == RDA5800_CHIPID) {
+        capabilities = 0x00;
+        stereoMask = RDA5800_STATUS_ST;
+    } else
+        capabilities = RDA5807M_CAP_ALL;
+};
+
+bool RDA5807M::makeImage(TRDA5807MRegisterFileWrite &image, byte band,
+                         word frequency, byte volume) {
+    image[RDA5807M_REG_CONFIG] = RDA5807M_FLG_DHIZ | RDA5807M_FLG_DMUTE |
+        RDA5807M_FLG_BASS | RDA5807M_FLG_SEEKUP | RDA5807M_FLG_RDS |
+        RDA5807M_FLG_NEW | RDA5807M_FLG_ENABLE;
+    image[RDA5807M_REG_TUNING] = (band & RDA5807M_BAND_MASK) |
+        RDA5807M_SPACE_100K;
+    //Power-on defaults
+    image[RDA5807M_REG_GPIO] = 0x0000;
+    image[RDA5807M_REG_VOLUME] = 0x888B;
+    image[RDA5807M_REG_I2S] = 0x0000;
+    image[RDA5807M_REG_BLEND] = 0x4202;
+    image[RDA5807M_REG_FREQ] = 0x0000;
+    image.set(RDA5807M_FIELD_VOLUME, volume);
+
+    const word channel = RDA5807MFrequencyChannel(
+        RDA5807MBandIndex(image[RDA5807M_REG_TUNING],
+                          image[RDA5807M_REG_BLEND]),
+        RDA5807M_SPACE_100K, frequency);
+
+    if (channel == RDA5807M_CHANNEL_INVALID)
+        return false;
+    image.set(RDA5807M_FIELD_CHAN, channel);
+
+    return true;
 };
 
 void RDA5807M::end(void) {
+    RDA5807M_OP(END);
+    word &config = shadow[RDA5807M_REG_CONFIG - RDA5807M_FIRST_REGISTER_WRITE];
+    const word kept = config & ~RDA5807M_FLG_ENABLE;
+
     setRegister(RDA5807M_REG_CONFIG, 0x00);
+    //The chip forgets the rest of CONFIG, the shadow copy keeps it for resume()
+    config = kept;
+    tunerState = RDA5807M_TUNER_IDLE;
+};
+
+void RDA5807M::standby(void) {
+    RDA5807M_OP(STANDBY);
+    updateRegister(RDA5807M_REG_CONFIG, RDA5807M_FLG_ENABLE, 0x00);
+    tunerState = RDA5807M_TUNER_IDLE;
+};
+
+void RDA5807M::resume(void) {
+    RDA5807M_OP(RESUME);
+    //Costs one extra transaction if nobody has read the shadow copy yet
+    if (!shadowValid)
+        resync();
+    powerUp(shadow);
+};
+
+void RDA5807M::powerUp(const word regs[]) {
+    word image[RDA5807M_SHADOW_SIZE];
+
+    for(byte i=0; i < RDA5807M_SHADOW_SIZE; i++)
+        image[i] = regs[i];
+    //A soft reset would undo the rest of the burst
+    image[RDA5807M_REG_CONFIG - RDA5807M_FIRST_REGISTER_WRITE] =
+        (image[RDA5807M_REG_CONFIG - RDA5807M_FIRST_REGISTER_WRITE] &
+         ~(RDA5807M_FLG_RESET | RDA5807M_FLG_SEEK)) | RDA5807M_FLG_ENABLE;
+    image[RDA5807M_REG_TUNING - RDA5807M_FIRST_REGISTER_WRITE] |=
+        RDA5807M_FLG_TUNE;
+    batching = false;
+    setRegisterBulk(RDA5807M_SHADOW_SIZE, image);
+    shadowValid = true;
+    startTuner(RDA5807M_TUNER_TUNING);
 };
 
 void RDA5807M::setRegister(byte reg, const word value) {
-    Wire.beginTransmission(RDA5807M_I2C_ADDR_RANDOM);
-    Wire.write(reg);
-    Wire.write(highByte(value));
-    Wire.write(lowByte(value));
-    Wire.endTransmission(true);
+    RDA5807M_OP(SETREGISTER);
+    if (batching && isShadowed(reg)) {
+        //Keep self-clearing bits until commit(), they are what we're after
+        shadow[reg - RDA5807M_FIRST_REGISTER_WRITE] = value;
+        dirty |= 1 << (reg - RDA5807M_FIRST_REGISTER_WRITE);
+        return;
+    };
+
+    //The shadow copy doesn't hold SEEK, don't abort a running seek with it
+    const word written = value | liveBits(reg);
+
+    bus.beginTransmission(RDA5807M_I2C_ADDR_RANDOM);
+    bus.write(reg);
+    bus.write(highByte(written));
+    bus.write(lowByte(written));
+    bus.endTransmission(true);
+
+    snapshotCount = 0;
+    if (isShadowed(reg))
+        shadow[reg - RDA5807M_FIRST_REGISTER_WRITE] = value &
+            ~selfClearingBits(reg);
+    //A soft reset brings the whole register file back to power-on defaults
+    if (reg == RDA5807M_REG_CONFIG && (value & RDA5807M_FLG_RESET))
+        shadowValid = false;
 };
 
 word RDA5807M::getRegister(byte reg) {
+    RDA5807M_OP(GETREGISTER);
     word result;
 
-    Wire.beginTransmission(RDA5807M_I2C_ADDR_RANDOM);
-    Wire.write(reg);
-    Wire.endTransmission(false);
-    Wire.requestFrom(RDA5807M_I2C_ADDR_RANDOM, (size_t)2, true);
+    bus.beginTransmission(RDA5807M_I2C_ADDR_RANDOM);
+    bus.write(reg);
+    bus.endTransmission(false);
+    bus.requestFrom(RDA5807M_I2C_ADDR_RANDOM, 2, true);
     //Don't let gcc play games on us, enforce order of execution.
-    result = (word)Wire.read() << 8;
-    result |= Wire.read();
+    result = (word)bus.read() << 8;
+    result |= bus.read();
 
     return result;
 };
 
+word RDA5807M::getShadowRegister(byte reg) {
+    RDA5807M_OP(GETSHADOWREGISTER);
+    if (!isShadowed(reg))
+        return getRegister(reg);
+
+    const byte index = reg - RDA5807M_FIRST_REGISTER_WRITE;
+
+    //Pending batch values are newer than anything the chip could tell us
+    if (dirty & (1 << index))
+        return shadow[index];
+
+    if (shadowPolicy == RDA5807M_SHADOW_REFRESH && selfClearingBits(reg))
+        return getRegister(reg);
+
+    if (!shadowValid)
+        resync();
+
+    return shadow[index];
+};
+
+void RDA5807M::resync(void) {
+    RDA5807M_OP(RESYNC);
+    readShadow(RDA5807M_FIRST_REGISTER_WRITE);
+};
+
+void RDA5807M::readShadow(byte first) {
+    //Random access reads auto-increment the register address, so the whole
+    //writable register file comes back in one transaction.
+    bus.beginTransmission(RDA5807M_I2C_ADDR_RANDOM);
+    bus.write(first);
+    bus.endTransmission(false);
+    bus.requestFrom(RDA5807M_I2C_ADDR_RANDOM,
+                    (RDA5807M_FIRST_REGISTER_WRITE + RDA5807M_SHADOW_SIZE -
+                     first) * 2, true);
+
+    for(byte reg = first;
+        reg < RDA5807M_FIRST_REGISTER_WRITE + RDA5807M_SHADOW_SIZE; reg++) {
+        const byte i = reg - RDA5807M_FIRST_REGISTER_WRITE;
+        //Don't let gcc play games on us, enforce order of execution.
+        word value = (word)bus.read() << 8;
+        value |= bus.read();
+
+        if (reg == RDA5807M_REG_CHIPID)
+            identify(value);
+        //Don't clobber pending batch values
+        else if (isShadowed(reg) && !(dirty & (1 << i)))
+            shadow[i] = value & ~selfClearingBits(reg);
+    };
+
+    shadowValid = true;
+};
+
+void RDA5807M::commit(void) {
+    RDA5807M_OP(COMMIT);
+    batching = false;
+
+    if (!dirty)
+        return;
+
+    byte last = 0, count = 0;
+
+    for(byte i=0; i < RDA5807M_SHADOW_SIZE; i++)
+        if (dirty & (1 << i)) {
+            last = i;
+            count++;
+        };
+
+    //Registers a sequential write would resend from the shadow copy
+    const byte stale = ~dirty & ((2 << last) - 1);
+
+    //A sequential write costs the address byte plus two bytes for every
+    //register up to the last dirty one. A random write costs the address
+    //byte, the register byte and two bytes of value for each dirty register.
+    if (shadowValid && 1 + 2 * (last + 1) <= 4 * count &&
+        !(shadowPolicy == RDA5807M_SHADOW_REFRESH && (stale & 0x03))) {
+        //CONFIG always goes out, keep a running seek going; the shadow copy
+        //drops the bit again on the way
+        shadow[0] |= liveBits(RDA5807M_REG_CONFIG);
+        setRegisterBulk(last + 1, shadow);
+    } else {
+        bus.beginMessageSet();
+        for(byte i=0; i <= last; i++)
+            if (dirty & (1 << i))
+                setRegister(RDA5807M_FIRST_REGISTER_WRITE + i, shadow[i]);
+        bus.endMessageSet();
+    };
+
+    dirty = 0x00;
+};
+
 void RDA5807M::setRegisterBulk(byte count, const word regs[]) {
-    Wire.beginTransmission(RDA5807M_I2C_ADDR_SEQRDA);
+    RDA5807M_OP(SETREGISTERBULK);
+    bus.beginTransmission(RDA5807M_I2C_ADDR_SEQRDA);
 
     for(byte i=0; i < count; i++) {
-        Wire.write(highByte(regs[i]));
-        Wire.write(lowByte(regs[i]));
+        bus.write(highByte(regs[i]));
+        bus.write(lowByte(regs[i]));
     };
 
-    Wire.endTransmission(true);
+    bus.endTransmission(true);
+
+    snapshotCount = 0;
+    for(byte i=0; i < count && i < RDA5807M_SHADOW_SIZE; i++) {
+        shadow[i] = regs[i] &
+            ~selfClearingBits(RDA5807M_FIRST_REGISTER_WRITE + i);
+        dirty &= ~(1 << i);
+    };
+    if (count && (regs[0] & RDA5807M_FLG_RESET))
+        shadowValid = false;
 };
 
 void RDA5807M::getRegisterBulk(byte count, word regs[]) {
-    Wire.requestFrom(RDA5807M_I2C_ADDR_SEQRDA, (size_t)(count * 2), true);
+    RDA5807M_OP(GETREGISTERBULK);
+    bus.requestFrom(RDA5807M_I2C_ADDR_SEQRDA, count * 2, true);
 
     for(byte i=0; i < count; i++) {
         //Don't let gcc play games on us, enforce order of execution.
-        regs[count] = (word)Wire.read() << 8;
-        regs[count] |= Wire.read();
+        regs[i] = (word)bus.read() << 8;
+        regs[i] |= bus.read();
     };
 };
 
 void RDA5807M::setRegisterBulk(const TRDA5807MRegisterFileWrite *regs) {
-    const uint8_t * const ptr = (uint8_t *)regs;
-
-    Wire.beginTransmission(RDA5807M_I2C_ADDR_SEQRDA);
-
-    for(byte i=0; i < sizeof(TRDA5807MRegisterFileWrite); i++)
-        Wire.write(ptr[i]);
-
-    Wire.endTransmission(true);
+    setRegisterBulk(RDA5807M_SHADOW_SIZE, regs->regs);
 };
 
 void RDA5807M::getRegisterBulk(TRDA5807MRegisterFileRead *regs) {
-    uint8_t * const ptr = (uint8_t *)regs;
-
-    Wire.requestFrom(RDA5807M_I2C_ADDR_SEQRDA,
-                     sizeof(TRDA5807MRegisterFileRead), true);
-
-    for(byte i=0; i < sizeof(TRDA5807MRegisterFileRead); i++)
-        ptr[i] = Wire.read();
-
+    getRegisterBulk(RDA5807M_STATUS_SIZE, regs->regs);
+
+    //Might as well keep it
+    snapshot.status = regs->regs[0];
+    snapshot.rssi = regs->regs[1];
+    for(byte i=0; i < 4; i++)
+        snapshot.rds[i] = regs->regs[i + 2];
+    snapshotCount = RDA5807M_STATUS_SIZE;
+    snapshotTime = millis();
 };
 
 bool RDA5807M::volumeUp(void) {
-    const byte volume = getRegister(RDA5807M_REG_VOLUME) & RDA5807M_VOLUME_MASK;
+    RDA5807M_OP(VOLUMEUP);
+    const byte volume = getShadowRegister(RDA5807M_REG_VOLUME) & RDA5807M_VOLUME_MASK;
 
     if (volume == RDA5807M_VOLUME_MASK)
         return false;
@@ -105,7 +326,8 @@ bool RDA5807M::volumeUp(void) {
 };
 
 bool RDA5807M::volumeDown(bool alsoMute) {
-    const byte volume = getRegister(RDA5807M_REG_VOLUME) & RDA5807M_VOLUME_MASK;
+    RDA5807M_OP(VOLUMEDOWN);
+    const byte volume = getShadowRegister(RDA5807M_REG_VOLUME) & RDA5807M_VOLUME_MASK;
 
     if (volume) {
         updateRegister(RDA5807M_REG_VOLUME, RDA5807M_VOLUME_MASK, volume - 1);
@@ -119,89 +341,491 @@ bool RDA5807M::volumeDown(bool alsoMute) {
 };
 
 void RDA5807M::seekUp(bool wrap) {
+    RDA5807M_OP(SEEKUP);
+    leaveDirectFrequency();
     updateRegister(RDA5807M_REG_CONFIG,
                    (RDA5807M_FLG_SEEKUP | RDA5807M_FLG_SEEK |
                     RDA5807M_FLG_SKMODE), 
                    (RDA5807M_FLG_SEEKUP | RDA5807M_FLG_SEEK |
                     (wrap ? 0x00 : RDA5807M_FLG_SKMODE)));
+    startTuner(RDA5807M_TUNER_SEEKING);
 };
 
 void RDA5807M::seekDown(bool wrap) {
+    RDA5807M_OP(SEEKDOWN);
+    leaveDirectFrequency();
     updateRegister(RDA5807M_REG_CONFIG,
                    (RDA5807M_FLG_SEEKUP | RDA5807M_FLG_SEEK |
                     RDA5807M_FLG_SKMODE), 
                    (0x00 | RDA5807M_FLG_SEEK |
                     (wrap ? 0x00 : RDA5807M_FLG_SKMODE)));
+    startTuner(RDA5807M_TUNER_SEEKING);
 };
 
 void RDA5807M::mute(void) {
+    RDA5807M_OP(MUTE);
     updateRegister(RDA5807M_REG_CONFIG, RDA5807M_FLG_DMUTE, 0x00);
 };
 
 void RDA5807M::unMute(bool minVolume) {
+    RDA5807M_OP(UNMUTE);
     if (minVolume)
         updateRegister(RDA5807M_REG_VOLUME, RDA5807M_VOLUME_MASK, 0x1);
     updateRegister(RDA5807M_REG_CONFIG, RDA5807M_FLG_DMUTE, RDA5807M_FLG_DMUTE);
 };
 
-const word RDA5807M_BandLowerLimits[5] PROGMEM = { 8700, 7600, 7600, 6500, 5000 };
-const word RDA5807M_BandHigherLimits[5] PROGMEM = { 10800, 9100, 10800, 7600, 6500 };
-const byte RDA5807M_ChannelSpacings[4] PROGMEM = { 100, 200, 50, 25 };
+const word RDA5807M_BandLowerLimits[RDA5807M_BANDS] PROGMEM = {
+    RDA5807MBandLowerLimit(0), RDA5807MBandLowerLimit(1),
+    RDA5807MBandLowerLimit(2), RDA5807MBandLowerLimit(3),
+    RDA5807MBandLowerLimit(4) };
+const word RDA5807M_BandHigherLimits[RDA5807M_BANDS] PROGMEM = {
+    RDA5807MBandHigherLimit(0), RDA5807MBandHigherLimit(1),
+    RDA5807MBandHigherLimit(2), RDA5807MBandHigherLimit(3),
+    RDA5807MBandHigherLimit(4) };
+const byte RDA5807M_ChannelSpacings[4] PROGMEM = {
+    RDA5807MSpacing(RDA5807M_SPACE_100K), RDA5807MSpacing(RDA5807M_SPACE_200K),
+    RDA5807MSpacing(RDA5807M_SPACE_50K), RDA5807MSpacing(RDA5807M_SPACE_25K) };
 
 word RDA5807M::getBandAndSpacing(void) {
-    byte band = getRegister(RDA5807M_REG_TUNING) & (RDA5807M_BAND_MASK |
-                                                    RDA5807M_SPACE_MASK);
-    //Separate channel spacing
-    const byte space = band & RDA5807M_SPACE_MASK;
+    const word tuning = getShadowRegister(RDA5807M_REG_TUNING);
+
+    return word(tuning & RDA5807M_SPACE_MASK,
+                RDA5807MBandIndex(tuning,
+                                  getShadowRegister(RDA5807M_REG_BLEND)));
+};
 
-    if (band & RDA5807M_BAND_MASK == RDA5807M_BAND_EAST && 
-        !(getRegister(RDA5807M_REG_BLEND) & RDA5807M_FLG_EASTBAND65M))
-        //Lower band limit is 50MHz
-        band = (band >> RDA5807M_BAND_SHIFT) + 1;
-    else
-        band >>= RDA5807M_BAND_SHIFT;
+const TRDA5807MStatus &RDA5807M::refreshStatus(byte count) {
+    const unsigned long now = millis();
 
-    return word(space, band);
+    if (snapshotCount >= count && now - snapshotTime < snapshotMaxAge)
+        return snapshot;
+
+    word regs[RDA5807M_STATUS_SIZE];
+
+    getRegisterBulk(count, regs);
+    snapshot.status = regs[0];
+    if (count > 1)
+        snapshot.rssi = regs[1];
+    for(byte i=2; i < count; i++)
+        snapshot.rds[i - 2] = regs[i];
+    snapshotCount = count;
+    snapshotTime = now;
+
+    return snapshot;
 };
 
-word RDA5807M::getFrequency(void) {
+word RDA5807M::channelFrequency(word channel) {
     const word spaceandband = getBandAndSpacing();
 
-    return pgm_read_word(&RDA5807M_BandLowerLimits[lowByte(spaceandband)]) +
-        (getRegister(RDA5807M_REG_STATUS) & RDA5807M_READCHAN_MASK) *
-        pgm_read_byte(&RDA5807M_ChannelSpacings[highByte(spaceandband)]) / 10;
+    return RDA5807MChannelFrequency(lowByte(spaceandband),
+                                    highByte(spaceandband), channel);
 };
 
-bool RDA5807M::setFrequency(word frequency) {
-    const word spaceandband = getBandAndSpacing();
-    const word origin = pgm_read_word(
-        &RDA5807M_BandLowerLimits[lowByte(spaceandband)]);
+word RDA5807M::getFrequency(void) {
+    RDA5807M_OP(GETFREQUENCY);
+    //READCHAN means nothing in direct frequency mode, but we know what we set
+    if (getShadowRegister(RDA5807M_REG_BLEND) & RDA5807M_FLG_FREQMODE)
+        return RDA5807MDirectFrequency(lowByte(getBandAndSpacing()),
+                                       getShadowRegister(RDA5807M_REG_FREQ));
+
+    return channelFrequency(refreshStatus(1).status & RDA5807M_READCHAN_MASK);
+};
+
+bool RDA5807M::setBand(byte band, bool east50M) {
+    RDA5807M_OP(SETBAND);
+    band &= RDA5807M_BAND_MASK;
+
+    if ((band == RDA5807M_BAND_WORLD || band == RDA5807M_BAND_EAST) &&
+        !(capabilities & RDA5807M_CAP_BANDS))
+        return false;
+
+    if (band != RDA5807M_BAND_EAST)
+        updateRegister(RDA5807M_REG_TUNING, RDA5807M_BAND_MASK, band);
+    else {
+        beginBatch();
+        updateRegister(RDA5807M_REG_TUNING, RDA5807M_BAND_MASK, band);
+        updateRegister(RDA5807M_REG_BLEND, RDA5807M_FLG_EASTBAND65M,
+                       east50M ? 0x00 : RDA5807M_FLG_EASTBAND65M);
+        commit();
+    };
+
+    return true;
+};
+
+bool RDA5807M::setDirectFrequency(word frequency) {
+    RDA5807M_OP(SETDIRECTFREQUENCY);
+    if (!(capabilities & RDA5807M_CAP_FREQMODE))
+        return false;
+
+    const byte band = lowByte(getBandAndSpacing());
 
-    //Check that specified frequency falls within our current band limits
-    if (frequency < origin ||
-        frequency > pgm_read_word(
-            &RDA5807M_BandHigherLimits[lowByte(spaceandband)]))
+    if (frequency < RDA5807MBandLowerLimit(band) ||
+        frequency > RDA5807MBandHigherLimit(band))
         return false;
 
-    //Adjust start offset
-    frequency -= origin;
+    //Mode, offset from the bottom of the band in kHz and the tune command in
+    //one commit, which is three register writes
+    beginBatch();
+    updateRegister(RDA5807M_REG_BLEND, RDA5807M_FLG_FREQMODE,
+                   RDA5807M_FLG_FREQMODE);
+    setRegister(RDA5807M_REG_FREQ, RDA5807MDirectOffset(band, frequency));
+    updateRegister(RDA5807M_REG_TUNING, RDA5807M_FLG_TUNE, RDA5807M_FLG_TUNE);
+    commit();
+    startTuner(RDA5807M_TUNER_TUNING);
 
-    const byte spacing = pgm_read_byte(
-        &RDA5807M_ChannelSpacings[highByte(spaceandband)]);
+    return true;
+};
+
+bool RDA5807M::leaveDirectFrequency(void) {
+    if (!(getShadowRegister(RDA5807M_REG_BLEND) & RDA5807M_FLG_FREQMODE))
+        return false;
+
+    updateRegister(RDA5807M_REG_BLEND, RDA5807M_FLG_FREQMODE, 0x00);
+
+    return true;
+};
+
+bool RDA5807M::setI2S(bool enable, word config) {
+    RDA5807M_OP(SETI2S);
+    if (!(capabilities & RDA5807M_CAP_I2S))
+        return false;
+
+    if (!enable)
+        updateRegister(RDA5807M_REG_GPIO, RDA5807P_FLG_I2S, 0x00);
+    else {
+        beginBatch();
+        updateRegister(RDA5807M_REG_GPIO, RDA5807P_FLG_I2S, RDA5807P_FLG_I2S);
+        setRegister(RDA5807M_REG_I2S, config);
+        commit();
+    };
+
+    return true;
+};
+
+bool RDA5807M::setFrequency(word frequency) {
+    RDA5807M_OP(SETFREQUENCY);
+    const word spaceandband = getBandAndSpacing();
+    //Out of band, between channels at the current spacing or out of reach
+    const word channel = RDA5807MFrequencyChannel(lowByte(spaceandband),
+                                                  highByte(spaceandband),
+                                                  frequency);
 
-    //Check that the given frequency can be tuned given current channel spacing
-    if (frequency * 10 % spacing)
+    if (channel == RDA5807M_CHANNEL_INVALID)
         return false;
 
+    leaveDirectFrequency();
     //Attempt to tune to the requested frequency
     updateRegister(RDA5807M_REG_TUNING, RDA5807M_CHAN_MASK | RDA5807M_FLG_TUNE,
-                   ((frequency * 10 / spacing) << RDA5807M_CHAN_SHIFT) |
-                   RDA5807M_FLG_TUNE);
+                   (channel << RDA5807M_CHAN_SHIFT) | RDA5807M_FLG_TUNE);
+    startTuner(RDA5807M_TUNER_TUNING);
+
+    return true;
+};
+
+bool RDA5807M::setTuning(word tuning) {
+    RDA5807M_OP(SETTUNING);
+    const byte band = tuning & RDA5807M_BAND_MASK;
+
+    if ((band == RDA5807M_BAND_WORLD || band == RDA5807M_BAND_EAST) &&
+        !(capabilities & RDA5807M_CAP_BANDS))
+        return false;
+
+    leaveDirectFrequency();
+    setRegister(RDA5807M_REG_TUNING, tuning | RDA5807M_FLG_TUNE);
+    startTuner(RDA5807M_TUNER_TUNING);
 
     return true;
 };
 
 byte RDA5807M::getRSSI(void) {
-    return (getRegister(RDA5807M_REG_RSSI) & RDA5807M_RSSI_MASK) >> RDA5807M_RSSI_SHIFT;
+    RDA5807M_OP(GETRSSI);
+    return (refreshStatus(2).rssi & RDA5807M_RSSI_MASK) >> RDA5807M_RSSI_SHIFT;
+};
+
+bool RDA5807M::readRDSGroup(TRDA5807MRDSGroup &group) {
+    RDA5807M_OP(READRDSGROUP);
+    //Whatever the snapshot policy, a group already handed out must not be
+    //handed out again
+    snapshotCount = 0;
+    const TRDA5807MStatus &status = refreshStatus(RDA5807M_STATUS_SIZE);
+
+    if (!(status.status & RDA5807M_STATUS_RDSR))
+        return false;
+
+    for(byte i=0; i < 4; i++)
+        group.blocks[i] = status.rds[i];
+    group.bler = status.rssi & (RDA5807M_BLERA_MASK | RDA5807M_BLERB_MASK);
+    group.time = snapshotTime;
+
+    return true;
+};
+
+bool RDA5807M::isStereo(void) {
+    RDA5807M_OP(ISSTEREO);
+    return refreshStatus(1).status & stereoMask;
 };
 
+
+void RDA5807M::startTuner(byte state) {
+    tunerState = state;
+    tunerStart = millis();
+    tunerNext = tunerStart + (state == RDA5807M_TUNER_SEEKING ?
+                              RDA5807M_SEEK_SETTLE_MS :
+                              RDA5807M_TUNE_SETTLE_MS);
+};
+
+byte RDA5807M::tick(unsigned long now) {
+    RDA5807M_OP(TICK);
+    const bool seeking = (tunerState == RDA5807M_TUNER_SEEKING);
+    const bool busy = seeking || tunerState == RDA5807M_TUNER_TUNING;
+    const bool timedOut = busy &&
+        now - tunerStart >= (seeking ? RDA5807M_SEEK_TIMEOUT_MS :
+                             RDA5807M_TUNE_TIMEOUT_MS);
+
+    if (interruptMode) {
+        //Edges are the only reason to touch the bus, bar a lost one
+        if (!irqPending && !timedOut)
+            return tunerState;
+
+        //Clear first so an edge arriving during the read isn't lost
+        irqPending = false;
+        snapshotCount = 0;
+        //Reading through RDA5807M_REG_RDSA is also what releases GPIO2
+        refreshStatus(RDA5807M_STATUS_SIZE);
+        if ((snapshot.status & RDA5807M_STATUS_RDSR) && rdsCallback)
+            rdsCallback(snapshot);
+        if (!busy)
+            return tunerState;
+    } else {
+        //Not due yet, keep off the bus
+        if (!busy || (long)(now - tunerNext) < 0)
+            return tunerState;
+
+        //STC may have come up since the last snapshot, never serve it from
+        //memory
+        snapshotCount = 0;
+        refreshStatus(2);
+    };
+
+    return updateTuner(now);
+};
+
+byte RDA5807M::updateTuner(unsigned long now) {
+    const bool seeking = (tunerState == RDA5807M_TUNER_SEEKING);
+    const bool timedOut = now - tunerStart >=
+        (seeking ? RDA5807M_SEEK_TIMEOUT_MS : RDA5807M_TUNE_TIMEOUT_MS);
+    const word status = snapshot.status;
+
+    if (status & RDA5807M_STATUS_STC) {
+        tunerState = (status & RDA5807M_STATUS_SF) ? RDA5807M_TUNER_FAILED :
+            RDA5807M_TUNER_SETTLED;
+        //A seek leaves the channel it found in READCHAN only, bring the
+        //shadow copy in line so later writes to TUNING don't undo it.
+        if (seeking && shadowValid &&
+            !(dirty & (1 << (RDA5807M_REG_TUNING -
+                             RDA5807M_FIRST_REGISTER_WRITE)))) {
+            word &tuning = shadow[RDA5807M_REG_TUNING -
+                                  RDA5807M_FIRST_REGISTER_WRITE];
+
+            tuning = (tuning & ~RDA5807M_CHAN_MASK) |
+                ((status & RDA5807M_READCHAN_MASK) << RDA5807M_CHAN_SHIFT);
+        };
+    } else if (timedOut)
+        tunerState = RDA5807M_TUNER_FAILED;
+    else {
+        tunerNext = now + (seeking ? RDA5807M_SEEK_POLL_MS :
+                           RDA5807M_TUNE_POLL_MS);
+        return tunerState;
+    };
+
+    if (tuneCallback)
+        tuneCallback(channelFrequency(status & RDA5807M_READCHAN_MASK),
+                     (snapshot.rssi & RDA5807M_RSSI_MASK) >>
+                     RDA5807M_RSSI_SHIFT,
+                     tunerState == RDA5807M_TUNER_FAILED);
+
+    return tunerState;
+};
+
+word RDA5807M::liveBits(byte reg) {
+    if (reg != RDA5807M_REG_CONFIG || tunerState != RDA5807M_TUNER_SEEKING)
+        return 0x00;
+
+    //Nothing may have polled since the seek started. Once it's over, SEEK
+    //would start another one.
+    snapshotCount = 0;
+    refreshStatus(2);
+
+    return updateTuner(millis()) == RDA5807M_TUNER_SEEKING ?
+        RDA5807M_FLG_SEEK : 0x00;
+};
+
+bool RDA5807M::enableInterrupts(bool rds) {
+    RDA5807M_OP(ENABLEINTERRUPTS);
+    if (!(capabilities & RDA5807M_CAP_INTERRUPTS))
+        return false;
+
+    beginBatch();
+    updateRegister(RDA5807M_REG_GPIO, RDA5807P_FLG_RDSIEN |
+                   RDA5807P_FLG_STCIEN | RDA5807P_GPIO2_MASK,
+                   (rds ? RDA5807P_FLG_RDSIEN : 0x00) | RDA5807P_FLG_STCIEN |
+                   RDA5807P_GPIO2_INT);
+    //Hold the line low until RDSA is read rather than pulse it for 5ms, so an
+    //edge we were too busy to service is still there for the timeout read.
+    updateRegister(RDA5807M_REG_VOLUME, RDA5807P_FLG_INTMODE,
+                   RDA5807P_FLG_INTMODE);
+    commit();
+    irqPending = false;
+    interruptMode = true;
+
+    return true;
+};
+
+void RDA5807M::disableInterrupts(void) {
+    RDA5807M_OP(DISABLEINTERRUPTS);
+    interruptMode = false;
+    updateRegister(RDA5807M_REG_GPIO, RDA5807P_FLG_RDSIEN |
+                   RDA5807P_FLG_STCIEN | RDA5807P_GPIO2_MASK,
+                   RDA5807P_GPIO2_HIZ);
+    //Don't leave a seek or tune waiting for an edge that will never come
+    tunerNext = millis();
+};
+
+void RDA5807M::scanProbe(word channel, word &transactions) {
+    setRegister(RDA5807M_REG_TUNING,
+                (getShadowRegister(RDA5807M_REG_TUNING) &
+                 ~RDA5807M_CHAN_MASK) |
+                (channel << RDA5807M_CHAN_SHIFT) | RDA5807M_FLG_TUNE);
+    transactions++;
+    delay(RDA5807M_SCAN_DWELL_MS);
+
+    for(byte i=0; i < RDA5807M_TUNE_TIMEOUT_MS / RDA5807M_SCAN_POLL_MS; i++) {
+        snapshotCount = 0;
+        refreshStatus(2);
+        transactions++;
+        if (snapshot.status & RDA5807M_STATUS_STC)
+            return;
+        delay(RDA5807M_SCAN_POLL_MS);
+    };
+};
+
+byte RDA5807M::scan(TRDA5807MStation stations[], byte size, byte flags,
+                    TRDA5807MScanStats *stats) {
+    RDA5807M_OP(SCAN);
+    const unsigned long start = millis();
+    word transactions = 0;
+    const word config = getShadowRegister(RDA5807M_REG_CONFIG);
+    const word tuning = getShadowRegister(RDA5807M_REG_TUNING);
+    const word blend = getShadowRegister(RDA5807M_REG_BLEND);
+    const word freq = getShadowRegister(RDA5807M_REG_FREQ);
+    const word spaceandband = getBandAndSpacing();
+    const word channels = RDA5807MLastChannel(lowByte(spaceandband),
+                                              highByte(spaceandband));
+    //Coarse pass at 200kHz: every (8 >> shift)th channel
+    const byte step = flags & RDA5807M_SCAN_TWOPASS ?
+        8 >> RDA5807MSpacingShift(highByte(spaceandband)) : 1;
+    const byte threshold = (getShadowRegister(RDA5807M_REG_VOLUME) &
+                            RDA5807M_SEEKTH_MASK) >> RDA5807M_SEEKTH_SHIFT;
+    byte found = 0;
+
+    //Probes go by channel number
+    if (leaveDirectFrequency())
+        transactions++;
+    setRegister(RDA5807M_REG_CONFIG, config & ~RDA5807M_FLG_DMUTE);
+    transactions++;
+
+    for(word channel = 0; channel <= channels && found < size;
+        channel += step) {
+        scanProbe(channel, transactions);
+        //On a coarse pass, a station one channel away won't raise FMTRUE
+        //but will still lift RSSI over the seek threshold
+        if (!(snapshot.rssi & RDA5807M_FLG_FMTRUE) &&
+            (step == 1 || ((snapshot.rssi & RDA5807M_RSSI_MASK) >>
+                           RDA5807M_RSSI_SHIFT) < threshold))
+            continue;
+
+        word best = channel;
+        word bestRSSI = snapshot.rssi & RDA5807M_FLG_FMTRUE ? snapshot.rssi : 0;
+        bool stereo = snapshot.status & stereoMask;
+
+        //Fine pass: the coarse hit may be spill from a neighbouring channel
+        for(byte i=1; i < step; i++)
+            for(int8_t sign = -1; sign <= 1; sign += 2) {
+                const word neighbour = channel + sign * i;
+
+                if (neighbour > channels)
+                    continue;
+                scanProbe(neighbour, transactions);
+                if ((snapshot.rssi & RDA5807M_FLG_FMTRUE) &&
+                    (snapshot.rssi & RDA5807M_RSSI_MASK) >
+                    (bestRSSI & RDA5807M_RSSI_MASK)) {
+                    best = neighbour;
+                    bestRSSI = snapshot.rssi;
+                    stereo = snapshot.status & stereoMask;
+                };
+            };
+        if (!(bestRSSI & RDA5807M_FLG_FMTRUE))
+            continue;
+
+        const word frequency = channelFrequency(best);
+        const byte rssi = (bestRSSI & RDA5807M_RSSI_MASK) >>
+            RDA5807M_RSSI_SHIFT;
+
+        //Adjacent channel spill of the previous station, keep the stronger
+        if (found &&
+            frequency - stations[found - 1].frequency <=
+            RDA5807M_SCAN_MERGE_SPAN) {
+            if (rssi <= stations[found - 1].rssi)
+                continue;
+            found--;
+        };
+        stations[found].frequency = frequency;
+        stations[found].rssi = rssi;
+        stations[found].stereo = stereo;
+        stations[found].pi = 0x0000;
+        found++;
+    };
+
+    if (flags & RDA5807M_SCAN_PI)
+        for(byte i=0; i < found; i++) {
+            scanProbe(RDA5807MFrequencyChannel(lowByte(spaceandband),
+                                               highByte(spaceandband),
+                                               stations[i].frequency),
+                      transactions);
+            for(word t=0; t < RDA5807M_SCAN_PI_TIMEOUT_MS;
+                t += RDA5807M_SCAN_PI_POLL_MS) {
+                delay(RDA5807M_SCAN_PI_POLL_MS);
+                snapshotCount = 0;
+                refreshStatus(RDA5807M_STATUS_SIZE);
+                transactions++;
+                if ((snapshot.status & RDA5807M_STATUS_RDSR) &&
+                    (snapshot.rssi & RDA5807M_BLERA_MASK) <=
+                    RDA5807M_BLERA_12) {
+                    stations[i].pi = snapshot.rds[0];
+                    //Stereo detection has had time to settle by now too
+                    stations[i].stereo = snapshot.status & stereoMask;
+                    break;
+                };
+            };
+        };
+
+    //Back to where we were, with the audio as it was. In direct frequency
+    //mode, where we were is FREQ rather than the channel.
+    beginBatch();
+    setRegister(RDA5807M_REG_CONFIG, config);
+    setRegister(RDA5807M_REG_TUNING, tuning | RDA5807M_FLG_TUNE);
+    if (blend & RDA5807M_FLG_FREQMODE) {
+        setRegister(RDA5807M_REG_BLEND, blend);
+        setRegister(RDA5807M_REG_FREQ, freq);
+    };
+    commit();
+    transactions++;
+    startTuner(RDA5807M_TUNER_TUNING);
+
+    if (stats) {
+        stats->elapsed = millis() - start;
+        stats->transactions = transactions;
+    };
+
+    return found;
+};
@@ -15,14 +15,45 @@
 
 #if defined(ARDUINO) && ARDUINO >= 100
 # include <Arduino.h>
-#else
+#elif defined(ARDUINO)
 # include <WProgram.h>
+#else
+# include "RDA5807M-Host.h"
 #endif
 
 //Register file origins for sequential mode
 #define RDA5807M_FIRST_REGISTER_WRITE 0x02
 #define RDA5807M_FIRST_REGISTER_READ 0x0A
 #define RDA5807M_LAST_REGISTER 0x3A
+//Writable registers mirrored by the shadow copy (0x02 to 0x08)
+#define RDA5807M_SHADOW_SIZE 7
+
+//Readable registers covered by the status snapshot (0x0A to 0x0F)
+#define RDA5807M_STATUS_SIZE 6
+
+//Tuning engine states, see tick()
+#define RDA5807M_TUNER_IDLE 0x0
+#define RDA5807M_TUNER_TUNING 0x1
+#define RDA5807M_TUNER_SEEKING 0x2
+#define RDA5807M_TUNER_SETTLED 0x3
+#define RDA5807M_TUNER_FAILED 0x4
+
+//Scan engine flags, see scan()
+#define RDA5807M_SCAN_TWOPASS 0x01
+#define RDA5807M_SCAN_PI 0x02
+
+//Chip capabilities, see getCapabilities()
+#define RDA5807M_CAP_RDS 0x01
+#define RDA5807M_CAP_INTERRUPTS 0x02
+#define RDA5807M_CAP_I2S 0x04
+//RDA5807M_BAND_WORLD, RDA5807M_BAND_EAST and its 50MHz variant
+#define RDA5807M_CAP_BANDS 0x08
+#define RDA5807M_CAP_FREQMODE 0x10
+#define RDA5807M_CAP_ALL 0x1F
+
+//Shadow copy coherency policies, see setShadowPolicy()
+#define RDA5807M_SHADOW_CACHED 0x0
+#define RDA5807M_SHADOW_REFRESH 0x1
 
 //Register addresses
 #define RDA5807M_REG_CHIPID 0x00
@@ -78,6 +109,7 @@
 #define RDA5807M_FLG_FMREADY word(0x0080)
 #define RDA5807M_FLG_BLOCKE word(0x0010)
 #define RDA5807P_FLG_STCIEN 0x4000
+#define RDA5807P_FLG_RDSIEN 0x8000
 #define RDA5807P_FLG_I2S word(0x0040)
 #define RDA5807P_FLG_I2SSLAVE 0x1000
 #define RDA5807P_FLG_SWLR 0x0800
@@ -95,6 +127,8 @@
 //Masks and constants for configuration parameters
 //NOTE: the entire family, including the RDA5800, all report the same ChipID.
 #define RDA5807M_CHIPID 0x58
+//...but the low byte tells the RDA5800 apart from the rest of the family.
+#define RDA5800_CHIPID 0x5800
 #define RDA5807M_CLKMODE_MASK word(0x0070)
 #define RDA5807M_CLKMODE_32K (0x0 << 4)
 #define RDA5807M_CLKMODE_12M (0x1 << 4)
@@ -182,121 +216,65 @@
 #define RDA5800_LNAP_P (0x2 << 13)
 #define RDA5800_LNAP_BOTH (0x3 << 13)
 
-//DO NOT USE (begin) -----------------------------------------------------------
-//
-//One day, avr-gcc will take its role seriously and allow a way to enforce
-//struct packing order, because it's a very common idiom in the embedded world
-//and because the standard allows the implementation to define it.
-//Until then, the beautiful structs below are nothing but an exercise in C
-//calligraphy.
-typedef struct __attribute__ ((__packed__)) {
-    uint8_t disableHiZ:1;
-    uint8_t disableMute:1;
-    uint8_t mono:1;
-    uint8_t bass:1;
-    uint8_t rClkNotAlways:1;
-    uint8_t rClkInput:1;
-    uint8_t seekUp:1;
-    uint8_t seek:1;
-    uint8_t seekMode:1;
-    uint8_t clkMode:3;
-    uint8_t rds:1;
-    uint8_t newDemodulation:1;
-    uint8_t softReset:1;
-    uint8_t enable:1;
-    union {
-        uint16_t channel:10;
-        struct {
-            uint8_t channel5800;
-            uint8_t reserved5800_1:2;
-        };
-    };
-    uint8_t direct:1;
-    uint8_t tune:1;
-    union {
-        struct {
-            uint8_t band:2;
-            uint8_t space:2;
-        };
-        struct {
-            uint8_t reserved5800_2:1;
-            uint8_t space50kHz:1;
-            uint8_t band5800:1;
-            uint8_t space5800:1;
-        };
-    };
-    uint8_t reserved1:1;
-    uint8_t stcInterruptEnable:1;
-    uint8_t reserved2:2;
-    uint8_t deEmphasis:1;
-    uint8_t reserved3:1;
-    uint8_t softMute:1;
-    uint8_t afcDisable:1;
-    uint8_t reserved4:1;
-    uint8_t i2s:1;
-    uint8_t gpio3:2;
-    uint8_t gpio2:2;
-    uint8_t gpio1:2;
-    uint8_t interruptMode:1;
-    uint8_t seekThreshold:7;
-    union {
-      struct {
-          uint8_t lnaPort:2;
-          uint8_t lnaCurrent:2;
-      };
-      uint8_t volumeDSP:4;
-    };
-    uint8_t volume:4;
-    uint8_t reserved5:1;
-    uint8_t openMode:2;
-    uint8_t i2sMode:1;
-    uint8_t wsIsRight:1;
-    uint8_t invertSclkInput:1;
-    uint8_t signedData:1;
-    uint8_t invertWsInput:1;
-    uint8_t i2sSampleRate:4;
-    uint8_t invertWsOutput:1;
-    uint8_t invertSclkOutput:1;
-    uint8_t delayLeft:1;
-    uint8_t delayRight:1;
-    uint8_t reserved6:1;
-    uint8_t softBlendThreshold:5;
-    uint8_t bandLimit65M:1;
-    uint8_t reserved7:1;
-    uint8_t seekThresholdOld:6;
-    uint8_t softBlend:1;
-    uint8_t frequencyMode:1;
-    uint16_t frequencyDirect;
-} TRDA5807MRegisterFileWrite;
-
-typedef struct __attribute__ ((__packed__)) {
-    uint8_t rdsReady:1;
-    uint8_t seekTuneComplete:1;
-    uint8_t seekFail:1;
-    uint8_t rdsSynchronized:1;
-    uint8_t blockEFound:1;
-    uint8_t stereo:1;
-    union {
-        uint16_t readChannel:10;
-        struct {
-            uint8_t reserved5800_3:1;
-            uint8_t stereo5800:1;
-            uint8_t readChannel5800;
-        };
-    };
-    uint8_t rssi:7;
-    uint8_t isStation:1;
-    uint8_t ready:1;
-    uint8_t reserved:2;
-    uint8_t blockE:1;
-    uint8_t blerA:2;
-    uint8_t blerB:2;
-    uint16_t rdsA;
-    uint16_t rdsB;
-    uint16_t rdsC;
-    uint16_t rdsD;
-} TRDA5807MRegisterFileRead;
-//DO NOT USE (end)--------------------------------------------------------------
+#include "RDA5807M-Registers.h"
+
+//Status snapshot, registers RDA5807M_REG_STATUS to RDA5807M_REG_RDSD as read
+//in one sequential transaction. Decode with the RDA5807M_STATUS_* and
+//RDA5807M_READCHAN_MASK constants (status) and the RDA5807M_RSSI_*,
+//RDA5807M_FLG_FMTRUE and RDA5807M_BLER*_* constants (rssi).
+typedef struct {
+    word status;
+    word rssi;
+    word rds[4];
+} TRDA5807MStatus;
+
+//One raw RDS group, as read from RDA5807M_REG_RDSA through RDA5807M_REG_RDSD.
+typedef struct {
+    word blocks[4]; //A through D
+    byte bler; //RDA5807M_BLERA_MASK and RDA5807M_BLERB_MASK bits
+    unsigned long time; //millis() when read
+} TRDA5807MRDSGroup;
+
+//Scan engine results: one entry per station found and overall cost.
+typedef struct {
+    word frequency; //In 10kHz units
+    byte rssi;
+    bool stereo;
+    word pi; //0 if unknown or not requested
+} TRDA5807MStation;
+
+typedef struct {
+    unsigned long elapsed; //In milliseconds
+    word transactions;
+} TRDA5807MScanStats;
+
+//Tuning engine completion callback: frequency (in 10kHz units) and RSSI the
+//chip settled on and whether it reported a seek failure (or timed out).
+typedef void (*TRDA5807MTuneCallback)(word frequency, byte rssi, bool failed);
+
+//RDS ready callback for interrupt mode, gets the snapshot holding the group.
+typedef void (*TRDA5807MRDSCallback)(const TRDA5807MStatus &status);
+
+//Bus backend, selected at compile time: define RDA5807M_BUS_LINUX for Linux
+//i2c-dev, RDA5807M_BUS_SIMULATOR for the chip simulator or
+//RDA5807M_BUS_HEADER to the (quoted) name of a header providing an
+//RDA5807MBus class with the same interface as the one in RDA5807M-Wire.h.
+//Arduino Wire is the default.
+#if defined(RDA5807M_BUS_HEADER)
+# include RDA5807M_BUS_HEADER
+#elif defined(RDA5807M_BUS_LINUX)
+# include "RDA5807M-Linux.h"
+#elif defined(RDA5807M_BUS_SIMULATOR)
+# include "RDA5807M-Simulator.h"
+#else
+# include "RDA5807M-Wire.h"
+#endif
+
+#include "RDA5807M-Channels.h"
+
+//Define RDA5807M_INSTRUMENTATION to keep per-operation bus statistics, see
+//RDA5807M-Instrumentation.h. It costs nothing when left undefined.
+#include "RDA5807M-Instrumentation.h"
 
 extern const word RDA5807M_BandLowerLimits[];
 extern const word RDA5807M_BandHigherLimits[];
@@ -309,7 +287,14 @@ class RDA5807M
         * Description:
         *   This is the constructor, it initializes internal data structures.
         */
-        RDA5807M(void) {};
+        RDA5807M(void) : shadowValid(false),
+                         shadowPolicy(RDA5807M_SHADOW_CACHED),
+                         batching(false), dirty(0x00), snapshotCount(0),
+                         snapshotMaxAge(0), tunerState(RDA5807M_TUNER_IDLE),
+                         tuneCallback(NULL), interruptMode(false),
+                         irqPending(false), rdsCallback(NULL), chipID(0),
+                         capabilities(RDA5807M_CAP_ALL),
+                         stereoMask(RDA5807M_STATUS_ST) {};
 
         /*
         * Description:
@@ -319,20 +304,89 @@ class RDA5807M
 
         /*
         * Description:
-        *   Mutes and disables the chip.
+        *   Mutes and disables the chip. The rest of the configuration stays
+        *   in the shadow copy, for resume() to bring back.
         */
         void end(void);
 
         /*
         * Description:
         *   Initializes the RDA5807M, starts the radio and configures band
-        *   limits.
+        *   limits. Also identifies the chip, see getCapabilities(), in the
+        *   same read that fills in the shadow copy of the register file.
         * Parameters:
         *   band - The desired band limits, one of the RDA5807M_BAND_* 
         *          constants.
         */
         void begin(byte band);
 
+        /*
+        * Description:
+        *   Fast startup: programs the entire writable register file from a
+        *   precomputed image and starts tuning to the channel in it, all in
+        *   one sequential write. Use tick() or poll() to find out when audio
+        *   is up. The chip is identified first, see getCapabilities().
+        * Parameters:
+        *   image - register file to start with, e.g. from makeImage(). The
+        *           ENABLE and TUNE bits are added to it.
+        */
+        void begin(const TRDA5807MRegisterFileWrite &image);
+
+        /*
+        * Description:
+        *   Builds a register file image for begin(image): the configuration
+        *   begin(band) sets up, the chip's power-on defaults everywhere else,
+        *   tuned to the given frequency.
+        * Parameters:
+        *   image     - where to build the image.
+        *   band      - one of the RDA5807M_BAND_* constants.
+        *   frequency - in 10kHz units, on the 100kHz raster of band.
+        *   volume    - 0 to 15.
+        * Returns:
+        *   false if frequency isn't a channel of band, in which case the image
+        *   is tuned to the bottom of the band.
+        */
+        static bool makeImage(TRDA5807MRegisterFileWrite &image, byte band,
+                              word frequency, byte volume = 0xB);
+
+        /*
+        * Description:
+        *   Puts the chip in standby, where it draws a few microamps but stays
+        *   reachable on the bus. Everything written so far is retained in the
+        *   shadow copy of the register file.
+        */
+        void standby(void);
+
+        /*
+        * Description:
+        *   Wakes the chip from standby (or from end()) and restores all
+        *   settings, including the tuned channel, in one sequential write.
+        *   Use tick() or poll() to find out when audio is back up.
+        */
+        void resume(void);
+
+        /*
+        * Description:
+        *   Returns the ChipID register as read by begin(), 0 before that.
+        */
+        word getChipID(void) { return chipID; };
+
+        /*
+        * Description:
+        *   Returns what the chip identified by begin() can do, any
+        *   combination of the RDA5807M_CAP_* constants (all of them before
+        *   begin() has run). Operations needing a capability the chip lacks
+        *   return false without touching the bus.
+        */
+        byte getCapabilities(void) { return capabilities; };
+
+        /*
+        * Description:
+        *   Returns the bus backend this instance talks through, for backends
+        *   that need configuring (e.g. which device or chip to talk to).
+        */
+        RDA5807MBus &getBus(void) { return bus; };
+
         /*
         * Description:
         *   Getter and setter for single random access to registers.
@@ -347,16 +401,69 @@ class RDA5807M
 
         /*
         * Description:
-        *   Read-before-write setter for single random access to registers.
+        *   Getter for the shadow copy of the writable register file. Registers
+        *   0x02 to 0x08 are served from memory without touching the bus, any
+        *   other register is fetched with getRegister().
+        * Parameters:
+        *   reg - register to get, one of the RDA5807M_REG_* constants.
+        * Returns:
+        *   last value written to (or read from) the given register.
+        */
+        word getShadowRegister(byte reg);
+
+        /*
+        * Description:
+        *   Read-modify-write setter for single random access to registers.
+        *   The read is served from the shadow copy, so this normally costs a
+        *   single bus write.
         * Parameters:
         *   reg   - register to update, one of the RDA5807M_REG_* constants.
         *   mask  - mask of the bits that are to be updated.
         *   value - value to set the given register and bits to.
         */
         void updateRegister(byte reg, word mask, word value) {
-            setRegister(reg, getRegister(reg) & ~mask | value);
+            RDA5807M_OP(UPDATEREGISTER);
+            setRegister(reg, (getShadowRegister(reg) & ~mask) | value);
         };
 
+        /*
+        * Description:
+        *   Reloads the shadow copy of the writable register file from the chip
+        *   in a single transaction. Needed only if something else on the bus
+        *   has been talking to the chip behind our back.
+        */
+        void resync(void);
+
+        /*
+        * Description:
+        *   Selects how the shadow copy treats RDA5807M_REG_CONFIG and
+        *   RDA5807M_REG_TUNING, which the chip modifies on its own when a
+        *   seek or tune completes. The self-clearing SEEK and TUNE bits are
+        *   never kept in the shadow copy regardless of policy.
+        * Parameters:
+        *   policy - RDA5807M_SHADOW_CACHED to serve them from the shadow copy
+        *            (default) or RDA5807M_SHADOW_REFRESH to read them back from
+        *            the chip before every read-modify-write.
+        */
+        void setShadowPolicy(byte policy) { shadowPolicy = policy; };
+
+        /*
+        * Description:
+        *   Starts a batch: until commit() is called, writes to registers 0x02
+        *   to 0x08 only update the shadow copy and mark the register dirty.
+        *   Writes to any other register still go out immediately.
+        */
+        void beginBatch(void) { batching = true; };
+
+        /*
+        * Description:
+        *   Ends a batch and flushes all dirty registers to the chip, either as
+        *   one sequential write starting at RDA5807M_FIRST_REGISTER_WRITE or
+        *   as individual random access writes, whichever puts fewer bytes on
+        *   the wire.
+        */
+        void commit(void);
+
         /*
         * Description:
         *   Getter and setter for bulk sequential access to registers. Gets
@@ -371,18 +478,15 @@ class RDA5807M
         void setRegisterBulk(byte count, const word regs[]);
         void getRegisterBulk(byte count, word regs[]);
 
-//DO NOT USE (begin) -----------------------------------------------------------
         /*
         * Description:
-        *   Overloaded versions of the above, for use with the memory mapped
-        *   register file structs. This is needed because Arduino and RDS5807M
-        *   differ in endianness and so to maintain the correspondence between
-        *   struct fields and the actual values transferred, you need to process
-        *   the memory mapped struct byte-wise.
+        *   Overloaded versions of the above, moving the entire writable or
+        *   readable register file in one sequential transaction. Use the
+        *   RDA5807M_FIELD_* descriptors to get at individual fields. Reading
+        *   also refreshes the status snapshot, see getStatus().
         */
         void setRegisterBulk(const TRDA5807MRegisterFileWrite *regs);
         void getRegisterBulk(TRDA5807MRegisterFileRead *regs);
-//DO NOT USE (end) -------------------------------------------------------------
 
         /*
         * Description:
@@ -445,6 +549,47 @@ class RDA5807M
         */
         word getFrequency(void);
 
+        /*
+        * Description:
+        *   Selects the band limits for the next tune or seek.
+        * Parameters:
+        *   band    - one of the RDA5807M_BAND_* constants. RDA5807M_BAND_WORLD
+        *             and RDA5807M_BAND_EAST need RDA5807M_CAP_BANDS.
+        *   east50M - with RDA5807M_BAND_EAST, use 50-76MHz instead of
+        *             65-76MHz.
+        * Returns:
+        *   false, without touching the bus, if the chip lacks the band.
+        */
+        bool setBand(byte band, bool east50M = false);
+
+        /*
+        * Description:
+        *   Tunes to any frequency inside the current band, regardless of
+        *   channel spacing, using direct frequency mode. Needs
+        *   RDA5807M_CAP_FREQMODE. The next setFrequency() or seek goes back
+        *   to tuning by channel.
+        * Parameters:
+        *   frequency - in 10kHz units.
+        * Returns:
+        *   false, without touching the bus, if frequency is outside the band
+        *   or the chip has no direct frequency mode.
+        */
+        bool setDirectFrequency(word frequency);
+
+        /*
+        * Description:
+        *   Turns the I2S digital audio output on or off. Needs
+        *   RDA5807M_CAP_I2S.
+        * Parameters:
+        *   enable - whether to output I2S audio.
+        *   config - when enabling, the contents of RDA5807M_REG_I2S (master or
+        *            slave, sample rate, polarities), written in the same
+        *            transaction.
+        * Returns:
+        *   false, without touching the bus, if the chip has no I2S output.
+        */
+        bool setI2S(bool enable, word config = 0x0000);
+
         /*
         * Description:
         *   Tells the chip to tune to the given frequency if within the
@@ -454,6 +599,18 @@ class RDA5807M
         */
         bool setFrequency(word frequency);
 
+        /*
+        * Description:
+        *   Tunes straight from a precomputed RDA5807M_REG_TUNING value in a
+        *   single register write, with no reads and no arithmetic. Band and
+        *   spacing change along with the channel. See RDA5807MPresets.
+        * Parameters:
+        *   tuning - channel, band and spacing, as in RDA5807M_REG_TUNING. The
+        *            TUNE bit is added to it.
+        * Returns:
+        *   false, without touching the bus, if the chip lacks the band.
+        */
+        bool setTuning(word tuning);
 
         /*
         * Description:
@@ -462,12 +619,256 @@ class RDA5807M
         */
         byte getRSSI(void);
 
+        /*
+        * Description:
+        *   Returns true if the chip is currently receiving in stereo.
+        */
+        bool isStereo(void);
+
+        /*
+        * Description:
+        *   Returns true if the given status snapshot, e.g. from getStatus(),
+        *   says stereo. The stereo indicator bit differs across the family.
+        */
+        bool isStereo(const TRDA5807MStatus &status) {
+            return status.status & stereoMask;
+        };
+
+        /*
+        * Description:
+        *   Reads RDA5807M_REG_STATUS through RDA5807M_REG_RDSD in a single
+        *   transaction, regardless of setStatusMaxAge(), and hands out the
+        *   RDS group in there, if new. Reading it acknowledges it to the chip.
+        *   Meant for a producer feeding RDA5807MRDSQueue.
+        * Parameters:
+        *   group - where to put the group.
+        * Returns:
+        *   true if there was a new group, false otherwise.
+        */
+        bool readRDSGroup(TRDA5807MRDSGroup &group);
+
+        /*
+        * Description:
+        *   Reads RDA5807M_REG_STATUS through RDA5807M_REG_RDSD in a single
+        *   sequential transaction and returns the result. getFrequency(),
+        *   getRSSI() and isStereo() are served from the same snapshot.
+        */
+        const TRDA5807MStatus &getStatus(void) {
+            RDA5807M_OP(GETSTATUS);
+            return refreshStatus(RDA5807M_STATUS_SIZE);
+        };
+
+        /*
+        * Description:
+        *   Sets for how long a status snapshot is considered fresh. Getters
+        *   called within that window are served from memory at no bus cost.
+        *   Any register write makes the snapshot stale immediately.
+        * Parameters:
+        *   maxAge - staleness window in milliseconds, 0 (default) to read the
+        *            chip on every call.
+        */
+        void setStatusMaxAge(word maxAge) { snapshotMaxAge = maxAge; };
+
+        /*
+        * Description:
+        *   Advances the tuning engine. seekUp(), seekDown() and setFrequency()
+        *   start it and return immediately; calling this from the main loop
+        *   polls the chip for completion at a pace matching the datasheet
+        *   settle times (calls in between cost no bus traffic) and invokes
+        *   the completion callback once the chip settles or gives up.
+        *   In interrupt mode the chip is only read after handleInterrupt()
+        *   has been called, or once a seek or tune has timed out in case an
+        *   edge got lost.
+        * Parameters:
+        *   now - current time in milliseconds, as returned by millis().
+        * Returns:
+        *   the tuning engine state, one of the RDA5807M_TUNER_* constants.
+        */
+        byte tick(unsigned long now);
+        byte poll(void) { return tick(millis()); };
+
+        /*
+        * Description:
+        *   Returns the tuning engine state without touching the bus.
+        */
+        byte getTunerState(void) { return tunerState; };
+
+        /*
+        * Description:
+        *   Sets the function to be called when a seek or tune completes.
+        * Parameters:
+        *   callback - completion callback or NULL to disable.
+        */
+        void setTuneCallback(TRDA5807MTuneCallback callback) {
+            tuneCallback = callback;
+        };
+
+        /*
+        * Description:
+        *   Switches to interrupt mode: GPIO2 is configured as an active low
+        *   interrupt output asserted on seek/tune completion (and optionally
+        *   on RDS group ready) until the RDS registers are read. The host must
+        *   route the falling edge of GPIO2 to handleInterrupt(), e.g. with
+        *   attachInterrupt(). Needs RDA5807M_CAP_INTERRUPTS.
+        * Parameters:
+        *   rds - also interrupt when a new RDS group is ready.
+        * Returns:
+        *   false, without touching the bus, if the chip has no GPIO2
+        *   interrupt output.
+        */
+        bool enableInterrupts(bool rds = true);
+
+        /*
+        * Description:
+        *   Returns GPIO2 to high impedance and goes back to polled mode.
+        */
+        void disableInterrupts(void);
+
+        /*
+        * Description:
+        *   Returns true between enableInterrupts() and disableInterrupts().
+        */
+        bool isInterruptMode(void) { return interruptMode; };
+
+        /*
+        * Description:
+        *   Records a GPIO2 edge for the next tick(). Safe to call from an
+        *   interrupt service routine, it never touches the bus.
+        */
+        void handleInterrupt(void) { irqPending = true; };
+
+        /*
+        * Description:
+        *   Sets the function tick() calls in interrupt mode whenever a new
+        *   RDS group has been read.
+        * Parameters:
+        *   callback - RDS ready callback or NULL to disable.
+        */
+        void setRDSCallback(TRDA5807MRDSCallback callback) {
+            rdsCallback = callback;
+        };
+
+        /*
+        * Description:
+        *   Scans the currently configured band channel by channel and fills
+        *   in a station table sorted by frequency, with adjacent channel
+        *   spill merged into the strongest hit. Audio is muted for the
+        *   duration of the scan and the original channel, or direct
+        *   frequency, is retuned at the end. This blocks until done.
+        * Parameters:
+        *   stations - table to fill in.
+        *   size     - number of entries in the table, the scan stops early
+        *              when full.
+        *   flags    - any combination of RDA5807M_SCAN_TWOPASS (probe every
+        *              200kHz first, then only the neighbours of each hit) and
+        *              RDA5807M_SCAN_PI (wait for RDS on every station found
+        *              to fill in its PI, this is slow).
+        *   stats    - if not NULL, filled in with the total scan time and
+        *              number of bus transactions.
+        * Returns:
+        *   number of stations found.
+        */
+        byte scan(TRDA5807MStation stations[], byte size, byte flags = 0,
+                  TRDA5807MScanStats *stats = NULL);
+
     private:
+#if defined(RDA5807M_INSTRUMENTATION)
+        RDA5807MInstrumentedBus bus;
+#else
+        RDA5807MBus bus;
+#endif
+        word shadow[RDA5807M_SHADOW_SIZE];
+        bool shadowValid;
+        byte shadowPolicy;
+        bool batching;
+        byte dirty;
+        TRDA5807MStatus snapshot;
+        byte snapshotCount;
+        word snapshotMaxAge;
+        unsigned long snapshotTime;
+
+        /*
+        * Description:
+        *   Returns the status snapshot, reading at least the first count
+        *   status registers from the chip unless the snapshot is fresh.
+        */
+        const TRDA5807MStatus &refreshStatus(byte count);
+
+        byte tunerState;
+        unsigned long tunerStart, tunerNext;
+        TRDA5807MTuneCallback tuneCallback;
+        bool interruptMode;
+        volatile bool irqPending;
+        TRDA5807MRDSCallback rdsCallback;
+        word chipID;
+        byte capabilities;
+        word stereoMask;
+
+        /*
+        * Description:
+        *   Reads from register first up to the end of the shadow copy in one
+        *   transaction, identifying the chip on the way if first is
+        *   RDA5807M_REG_CHIPID.
+        */
+        void readShadow(byte first);
+
+        /*
+        * Description:
+        *   Caches what the chip with the given ChipID can do.
+        */
+        void identify(word id);
+
+        /*
+        * Description:
+        *   Leaves direct frequency mode, if in it, so the next tune or seek
+        *   goes by channel number. Returns whether that took a bus write.
+        */
+        bool leaveDirectFrequency(void);
+
+        /*
+        * Description:
+        *   Arms the tuning engine after a seek or tune command.
+        */
+        void startTuner(byte state);
+        void powerUp(const word regs[]);
+
+        /*
+        * Description:
+        *   Moves the tuning engine on from the status snapshot: to SETTLED
+        *   or FAILED once STC is up, to FAILED once it has timed out.
+        *   Returns the tuner state.
+        */
+        byte updateTuner(unsigned long now);
+
+        /*
+        * Description:
+        *   Self-clearing bits of the given register the chip may still hold
+        *   set, which a write from the shadow copy must keep or it would stop
+        *   what they started: SEEK in RDA5807M_REG_CONFIG while seeking. A
+        *   seek nobody polled may be over already, so that takes a status
+        *   read to find out.
+        */
+        word liveBits(byte reg);
+
         /*
         * Description:
         *   Returns the currently configured FM band and channel spacing.
         */
         word getBandAndSpacing(void);
+
+        /*
+        * Description:
+        *   Converts a channel number into a frequency in 10kHz units, using
+        *   the currently configured FM band and channel spacing.
+        */
+        word channelFrequency(word channel);
+
+        /*
+        * Description:
+        *   Tunes to the given channel and waits for the chip to settle,
+        *   leaving the result in the status snapshot.
+        */
+        void scanProbe(word channel, word &transactions);
 };
 
 #endif
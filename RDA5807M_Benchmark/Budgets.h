@@ -0,0 +1,65 @@
+//Budgets for RDA5807M_Benchmark: I2C transactions, bytes and
+//simulated microseconds each operation or scenario may use.
+//Generated with RDA5807M_Benchmark -u, see there.
+static const TBudget budgets[] = {
+    {"cold begin", 5, 38, 10884},
+    {"cold begin (image)", 3, 25, 10582},
+    {"setRegister", 1, 4, 95},
+    {"getRegister", 1, 5, 121},
+    {"getShadowRegister", 0, 0, 0},
+    {"updateRegister", 1, 4, 95},
+    {"resync", 1, 17, 391},
+    {"commit (3 registers)", 1, 11, 253},
+    {"getRegisterBulk", 1, 13, 298},
+    {"volumeUp", 1, 4, 95},
+    {"volumeDown", 1, 4, 95},
+    {"mute", 1, 4, 95},
+    {"unMute", 1, 4, 95},
+    {"getFrequency", 1, 3, 73},
+    {"getRSSI", 1, 5, 118},
+    {"isStereo", 1, 3, 73},
+    {"readRDSGroup", 1, 13, 298},
+    {"getStatus", 1, 13, 298},
+    {"tick (idle)", 0, 0, 0},
+    {"setFrequency", 1, 4, 95},
+    {"setFrequency + settle", 2, 9, 10213},
+    {"recall", 1, 4, 95},
+    {"seekUp + settle", 11, 54, 275275},
+    {"seekDown + settle", 11, 54, 275275},
+    {"mute during seek", 13, 63, 270488},
+    {"commit during seek", 13, 70, 270646},
+    {"mute after unpolled seek", 4, 17, 2000403},
+    {"setBand", 1, 4, 95},
+    {"setDirectFrequency + settle", 4, 17, 10403},
+    {"setFrequency (from direct)", 2, 8, 190},
+    {"setDirectFrequency (200k)", 4, 17, 10403},
+    {"setDirectFrequency (50k)", 4, 17, 10403},
+    {"setI2S", 2, 8, 190},
+    {"standby", 1, 4, 95},
+    {"resume + settle", 2, 20, 10461},
+    {"enableInterrupts", 2, 8, 190},
+    {"disableInterrupts", 1, 4, 95},
+    {"scan", 424, 1908, 1733156},
+    {"scan (two-pass, PI)", 352, 2247, 2700425},
+    {"scan (from direct)", 389, 1760, 1585642},
+    {"preset hopping (8)", 17, 76, 81799},
+    {"preset hopping (8, bank)", 16, 72, 81704},
+    {"RDS 60s (polled)", 1489, 19357, 60003722},
+    {"RDS 60s (paced)", 945, 12285, 60000610},
+    {"no RDS 60s (paced)", 46, 598, 60000708},
+    {"RDS 60s (interrupts)", 682, 8866, 60000236},
+    {"RDS 60s (queued)", 685, 8905, 60004130},
+    {"RDS 60s (captured)", 685, 8905, 60004130},
+    {"RDS replay (decoder)", 0, 0, 0},
+    {"idle 60s (interrupts)", 0, 0, 60000000},
+    {"RDS replay (simulator)", 685, 8905, 60183130},
+    {"setRegisterBulk", 1, 15, 343},
+    {"getRegisterBulk (file)", 1, 13, 298},
+    {"setRegisterBulk (file)", 1, 15, 343},
+    {"end", 1, 4, 95},
+    {"resume (from end) + settle", 2, 20, 10461},
+    {"unsupported (RDA5800)", 0, 0, 0},
+    {"AF probe (weaker)", 4, 20, 10472},
+    {"AF probe (other PI)", 17, 189, 274346},
+    {"AF switch", 17, 188, 274323},
+};
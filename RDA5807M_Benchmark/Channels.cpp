@@ -0,0 +1,223 @@
+/*
+* RDA5807M Channel Arithmetic Test
+*
+* This host program checks the constexpr channel arithmetic in
+* RDA5807M-Channels.h against the table-and-division formulas it replaced,
+* exhaustively: every band plan (all four band settings, with and without
+* the 50MHz east band flag) times every channel spacing, every channel
+* number, every 16-bit frequency and every 16-bit direct frequency offset,
+* plus RDA5807MChannelMap for every band and spacing. It then has the driver
+* tune every channel and, in direct frequency mode, every 10kHz step of each
+* of those band plans on the chip simulator and checks that the driver and
+* the chip both agree on where it went. Exits with status 1 if any check
+* fails.
+*
+* BUILDING AND RUNNING:
+* From the library directory:
+*   g++ -O2 -DRDA5807M_BUS_SIMULATOR -I. RDA5807M_Benchmark/Channels.cpp \
+*       RDA5807M.cpp RDA5807M-Simulator.cpp RDA5807M-Host.cpp -o channels
+*   ./channels
+*/
+
+#include <stdio.h>
+
+#include "RDA5807M.h"
+
+//The formulas RDA5807M-Channels.h replaced, plus the limit of the CHAN
+//field they missed
+static const word lowerLimits[RDA5807M_BANDS] = {8700, 7600, 7600, 6500,
+                                                 5000};
+static const word higherLimits[RDA5807M_BANDS] = {10800, 9100, 10800, 7600,
+                                                  6500};
+static const byte spacings[4] = {100, 200, 50, 25};
+
+static byte bandIndex(word tuning, word blend) {
+    const byte band = (tuning & RDA5807M_BAND_MASK) >> RDA5807M_BAND_SHIFT;
+
+    return band == (RDA5807M_BAND_EAST >> RDA5807M_BAND_SHIFT) &&
+        !(blend & RDA5807M_FLG_EASTBAND65M) ? RDA5807M_BAND_EAST_50M : band;
+};
+
+static word channelFrequency(byte band, byte space, word channel) {
+    return lowerLimits[band] + (unsigned long)channel * spacings[space] / 10;
+};
+
+static word frequencyChannel(byte band, byte space, word frequency) {
+    if (frequency < lowerLimits[band] || frequency > higherLimits[band])
+        return RDA5807M_CHANNEL_INVALID;
+
+    const unsigned long offset = (frequency - lowerLimits[band]) * 10UL;
+
+    if (offset % spacings[space] || offset / spacings[space] > 0x3FF)
+        return RDA5807M_CHANNEL_INVALID;
+
+    return offset / spacings[space];
+};
+
+static word lastChannel(byte band, byte space) {
+    const unsigned long last = (higherLimits[band] - lowerLimits[band]) *
+        10UL / spacings[space];
+
+    return last > 0x3FF ? 0x3FF : last;
+};
+
+static RDA5807MSimulator chip;
+static RDA5807M radio;
+static unsigned long checks = 0, failures = 0;
+
+static void check(bool ok, const char *what, byte band, byte space,
+                  unsigned long value) {
+    checks++;
+    if (ok)
+        return;
+
+    //The first few tell the story
+    if (failures++ < 10)
+        printf("FAILED: %s, band %u, spacing %u, at %lu\n", what, band, space,
+               value);
+};
+
+//RDA5807MChannelMap against the formulas, for one band and spacing
+template <byte band, byte space>
+static void checkMap(void) {
+    typedef RDA5807MChannelMap<band, space> Map;
+
+    check(Map::lowerLimit() == lowerLimits[band] &&
+          Map::higherLimit() == higherLimits[band] &&
+          Map::lastChannel() == lastChannel(band, space), "channel map limits",
+          band, space, 0);
+    for(word channel = 0; channel <= Map::lastChannel(); channel++)
+        check(Map::frequencyOf(channel) ==
+              channelFrequency(band, space, channel), "channel map frequency",
+              band, space, channel);
+    for(word frequency = Map::lowerLimit(); frequency <= Map::higherLimit();
+        frequency++)
+        check(Map::channelOf(frequency) ==
+              frequencyChannel(band, space, frequency), "channel map channel",
+              band, space, frequency);
+};
+
+#define CHECK_MAPS(band) do { \
+        checkMap<band, RDA5807M_SPACE_100K>(); \
+        checkMap<band, RDA5807M_SPACE_200K>(); \
+        checkMap<band, RDA5807M_SPACE_50K>(); \
+        checkMap<band, RDA5807M_SPACE_25K>(); \
+    } while (0)
+
+static void settle(void) {
+    while (radio.poll() < RDA5807M_TUNER_SETTLED)
+        delay(1);
+};
+
+int main(void) {
+    //Helpers that see every 16-bit value
+    for(unsigned long value = 0; value <= 0xFFFF; value++) {
+        check(RDA5807MDivideBy5(value) == value / 5, "divide by 5", 0, 0,
+              value);
+        for(byte blend = 0; blend < 2; blend++)
+            check(RDA5807MBandIndex(value,
+                                    blend ? RDA5807M_FLG_EASTBAND65M : 0) ==
+                  bandIndex(value, blend ? RDA5807M_FLG_EASTBAND65M : 0),
+                  "band index", 0, blend, value);
+    };
+
+    for(byte band = 0; band < RDA5807M_BANDS; band++) {
+        check(RDA5807MBandLowerLimit(band) == lowerLimits[band] &&
+              pgm_read_word(&RDA5807M_BandLowerLimits[band]) ==
+              lowerLimits[band], "lower limit", band, 0, 0);
+        check(RDA5807MBandHigherLimit(band) == higherLimits[band] &&
+              pgm_read_word(&RDA5807M_BandHigherLimits[band]) ==
+              higherLimits[band], "higher limit", band, 0, 0);
+        for(unsigned long offset = 0; offset <= 0xFFFF; offset++)
+            check(RDA5807MDirectFrequency(band, offset) ==
+                  lowerLimits[band] + offset / 10, "direct frequency", band, 0,
+                  offset);
+        for(word frequency = lowerLimits[band];
+            frequency <= higherLimits[band]; frequency++)
+            check(RDA5807MDirectOffset(band, frequency) ==
+                  (frequency - lowerLimits[band]) * 10UL, "direct offset",
+                  band, 0, frequency);
+
+        for(byte space = 0; space < 4; space++) {
+            check(RDA5807MSpacing(space) == spacings[space] &&
+                  pgm_read_byte(&RDA5807M_ChannelSpacings[space]) ==
+                  spacings[space], "spacing", band, space, 0);
+            check(RDA5807MLastChannel(band, space) == lastChannel(band, space),
+                  "last channel", band, space, 0);
+            //Every channel number READCHAN can hold
+            for(word channel = 0; channel <= RDA5807M_READCHAN_MASK;
+                channel++)
+                check(RDA5807MChannelFrequency(band, space, channel) ==
+                      channelFrequency(band, space, channel), "frequency",
+                      band, space, channel);
+            for(unsigned long frequency = 0; frequency <= 0xFFFF;
+                frequency++)
+                check(RDA5807MFrequencyChannel(band, space, frequency) ==
+                      frequencyChannel(band, space, frequency), "channel",
+                      band, space, frequency);
+        };
+    };
+
+    CHECK_MAPS(0);
+    CHECK_MAPS(1);
+    CHECK_MAPS(2);
+    CHECK_MAPS(3);
+    CHECK_MAPS(RDA5807M_BAND_EAST_50M);
+    printf("arithmetic: %lu checks, %lu failed\n", checks, failures);
+
+    //The driver, through getBandAndSpacing(), on every band plan
+    const unsigned long arithmetic = checks, arithmeticFailures = failures;
+    unsigned long tunes = 0;
+
+    RDA5807MSimulator::installClock();
+    radio.getBus().attach(chip);
+    radio.begin(RDA5807M_BAND_WEST);
+    for(byte band = 0; band < RDA5807M_BANDS; band++)
+        for(byte space = 0; space < 4; space++) {
+            radio.setBand(band == RDA5807M_BAND_EAST_50M ? RDA5807M_BAND_EAST :
+                          band << RDA5807M_BAND_SHIFT,
+                          band == RDA5807M_BAND_EAST_50M);
+            radio.updateRegister(RDA5807M_REG_TUNING, RDA5807M_SPACE_MASK,
+                                 space);
+            for(word channel = 0; channel <= lastChannel(band, space);
+                channel++) {
+                const word frequency = channelFrequency(band, space, channel);
+
+                //Every other 25kHz channel falls between 10kHz units
+                if (frequencyChannel(band, space, frequency) != channel)
+                    continue;
+                check(radio.setFrequency(frequency), "setFrequency", band,
+                      space, frequency);
+                settle();
+                check(radio.getFrequency() == frequency &&
+                      chip.getFrequency() == frequency, "tuned frequency",
+                      band, space, frequency);
+                tunes++;
+            };
+            //Past what CHAN can hold, but still inside the band
+            const word beyond = channelFrequency(band, space,
+                                                 lastChannel(band, space) + 1);
+
+            if (beyond <= higherLimits[band])
+                check(!radio.setFrequency(beyond), "unreachable channel",
+                      band, space, beyond);
+            for(word frequency = lowerLimits[band];
+                frequency <= higherLimits[band]; frequency++) {
+                check(radio.setDirectFrequency(frequency),
+                      "setDirectFrequency", band, space, frequency);
+                settle();
+                check(radio.getFrequency() == frequency &&
+                      chip.getFrequency() == frequency, "direct frequency",
+                      band, space, frequency);
+                tunes++;
+            };
+        };
+    radio.end();
+    printf("driver: %lu tunes, %lu checks, %lu failed\n", tunes,
+           checks - arithmetic, failures - arithmeticFailures);
+
+    if (failures)
+        printf("\nFAILED\n");
+
+    return failures ? 1 : 0;
+};
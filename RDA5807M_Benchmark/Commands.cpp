@@ -0,0 +1,203 @@
+/*
+* RDA5807M Command Queue Benchmark
+*
+* This host program shares one simulated receiver between several threads
+* through RDA5807MCommandQueue, the way a Linux controller with a UI, a
+* network API and a scheduler would:
+*   - a UI thread turning the volume up and down in bursts;
+*   - a network thread tuning to one station after another;
+*   - three scheduler threads, each driving its own GPIO field of
+*     RDA5807M_REG_GPIO with updateRegister();
+*   - a monitor thread reading RSSI.
+* Afterwards it checks that no update got lost (each GPIO field, the volume
+* and the frequency hold what their thread set last) and reports throughput,
+* how many commands were coalesced, the bus transactions that took and the
+* queueing latency. Last, it checks that volume steps queued up against
+* either end of the range come out as they would one by one. Exits with
+* status 1 if any check fails.
+*
+* BUILDING AND RUNNING:
+* From the library directory:
+*   g++ -O2 -pthread -DRDA5807M_BUS_SIMULATOR -I. \
+*       RDA5807M_Benchmark/Commands.cpp RDA5807M.cpp RDA5807M-Commands.cpp \
+*       RDA5807M-Simulator.cpp RDA5807M-Host.cpp -o commands
+*   ./commands
+*/
+
+#include <stdio.h>
+
+#include <thread>
+
+#include "RDA5807M.h"
+#include "RDA5807M-Commands.h"
+
+#define ROUNDS 2000
+#define BURST 5
+#define FINAL_VOLUME 9
+
+static const word stations[] = {8810, 9450, 10110, 9060, 10440};
+#define STATIONS (sizeof(stations) / sizeof(stations[0]))
+
+static const word gpioMasks[] = {RDA5807P_GPIO1_MASK, RDA5807P_GPIO2_MASK,
+                                 RDA5807P_GPIO3_MASK};
+static const byte gpioShifts[] = {0, 2, 4};
+#define GPIOS (sizeof(gpioMasks) / sizeof(gpioMasks[0]))
+
+//Declared before the queue, which may still talk to it on its way out
+static RDA5807MSimulator chip;
+static RDA5807M radio;
+
+static word begin(RDA5807M &radio, void *) {
+    radio.begin(RDA5807M_BAND_WEST);
+
+    return 0;
+};
+
+//Waits, on the worker, for the last tune to settle
+static word settle(RDA5807M &radio, void *) {
+    while (radio.poll() < RDA5807M_TUNER_SETTLED)
+        delay(1);
+
+    return radio.getFrequency();
+};
+
+//Keeps the worker busy until released, so what's submitted meanwhile
+//queues up
+static word hold(RDA5807M &, void *context) {
+    ((std::shared_future<void> *)context)->wait();
+
+    return 0;
+};
+
+//Sets the volume, then steps it once each way behind a held worker.
+//Returns the volume the last step left.
+static word clamp(RDA5807MCommandQueue &queue, byte volume, bool up) {
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    TRDA5807MCommandResult result;
+
+    queue.call(hold, &released);
+    queue.setVolume(volume);
+    if (up) {
+        queue.volumeUp();
+        result = queue.volumeDown();
+    } else {
+        queue.volumeDown();
+        result = queue.volumeUp();
+    };
+    release.set_value();
+
+    return result.get();
+};
+
+static void ui(RDA5807MCommandQueue &queue) {
+    for(word i = 0; i < ROUNDS; i++)
+        for(byte j = 0; j < BURST; j++)
+            if (i & 1)
+                queue.volumeDown();
+            else
+                queue.volumeUp();
+    queue.setVolume(FINAL_VOLUME).wait();
+};
+
+static void network(RDA5807MCommandQueue &queue) {
+    for(word i = 0; i < ROUNDS; i++)
+        queue.setFrequency(stations[i % STATIONS]);
+};
+
+static void scheduler(RDA5807MCommandQueue &queue, byte gpio) {
+    for(word i = 0; i < ROUNDS; i++)
+        queue.updateRegister(RDA5807M_REG_GPIO, gpioMasks[gpio],
+                             ((i + gpio) & 0x3) << gpioShifts[gpio]);
+};
+
+static void monitor(RDA5807MCommandQueue &queue) {
+    for(word i = 0; i < ROUNDS; i++)
+        queue.getRSSI().wait();
+};
+
+int main(void) {
+    bool failed = false;
+
+    RDA5807MSimulator::installClock();
+    chip.setChipID(0x5804);
+    for(byte i = 0; i < STATIONS; i++)
+        chip.addStation(stations[i], 30 + i * 5);
+    radio.getBus().attach(chip);
+
+    RDA5807MCommandQueue queue(radio);
+
+    queue.call(begin, NULL).wait();
+    queue.clearStats();
+
+    const unsigned long transactions = chip.getStats().transactions;
+    std::thread threads[3 + GPIOS];
+    byte count = 0;
+
+    threads[count++] = std::thread(ui, std::ref(queue));
+    threads[count++] = std::thread(network, std::ref(queue));
+    threads[count++] = std::thread(monitor, std::ref(queue));
+    for(byte i = 0; i < GPIOS; i++)
+        threads[count++] = std::thread(scheduler, std::ref(queue), i);
+    for(byte i = 0; i < count; i++)
+        threads[i].join();
+    queue.flush();
+
+    const TRDA5807MCommandStats stats = queue.getStats();
+    const word frequency = queue.call(settle, NULL).get();
+    const word gpio = chip.getRegister(RDA5807M_REG_GPIO);
+    const byte volume = chip.getRegister(RDA5807M_REG_VOLUME) &
+        RDA5807M_VOLUME_MASK;
+    word expectedGPIO = 0x0000;
+
+    for(byte i = 0; i < GPIOS; i++)
+        expectedGPIO |= ((ROUNDS - 1 + i) & 0x3) << gpioShifts[i];
+
+    printf("threads                        %8u\n", count);
+    printf("commands submitted             %8lu\n", stats.submitted);
+    printf("commands run                   %8lu\n", stats.executed);
+    printf("coalesced                      %8lu (%.1f%%)\n", stats.coalesced,
+           stats.coalesced * 100.0 / stats.submitted);
+    printf("bus transactions               %8lu\n",
+           chip.getStats().transactions - transactions);
+    printf("waits for room                 %8lu\n", stats.waits);
+    printf("deepest queue                  %8u / %u\n", stats.maxDepth,
+           RDA5807M_COMMANDS_DEPTH);
+    printf("submissions per second         %8.0f\n",
+           stats.submitted * 1000000.0 / stats.elapsedMicros);
+    printf("worker busy                    %8.1f%%\n",
+           stats.busyMicros * 100.0 / stats.elapsedMicros);
+    printf("queueing latency (us)          %8.1f mean, %lu max\n",
+           (double)stats.latencyMicros / stats.submitted,
+           stats.maxLatencyMicros);
+    printf("latency histogram (<%uus, x2...)",
+           RDA5807M_COMMANDS_HISTOGRAM_BASE);
+    for(byte i = 0; i < RDA5807M_COMMANDS_HISTOGRAM_BUCKETS; i++)
+        printf(" %lu", stats.histogram[i]);
+    printf("\n");
+    printf("GPIO                             0x%04X (expected 0x%04X)\n",
+           gpio, expectedGPIO);
+    printf("volume                         %8u (expected %u)\n", volume,
+           FINAL_VOLUME);
+    printf("frequency                      %8u (expected %u)\n", frequency,
+           stations[(ROUNDS - 1) % STATIONS]);
+
+    const word top = clamp(queue, RDA5807M_VOLUME_MASK, true);
+    const word bottom = clamp(queue, 0, false);
+
+    printf("volume 15, up, down            %8u (expected %u)\n", top,
+           RDA5807M_VOLUME_MASK - 1);
+    printf("volume 0, down, up             %8u (expected 1)\n", bottom);
+
+    if ((gpio & (RDA5807P_GPIO1_MASK | RDA5807P_GPIO2_MASK |
+                 RDA5807P_GPIO3_MASK)) != expectedGPIO ||
+        volume != FINAL_VOLUME ||
+        frequency != stations[(ROUNDS - 1) % STATIONS] ||
+        stats.submitted != stats.executed + stats.coalesced ||
+        top != RDA5807M_VOLUME_MASK - 1 || bottom != 1)
+        failed = true;
+    if (failed)
+        printf("\nFAILED\n");
+
+    return failed ? 1 : 0;
+};
@@ -0,0 +1,202 @@
+/*
+* RDA5807M Coroutine Benchmark
+*
+* This host program drives N simulated receivers through the same session
+* (tune to a station, receive RDS groups, seek up twice) in three ways:
+*   - coroutines on one thread, polling the chips;
+*   - coroutines on one thread, woken by GPIO2 interrupts;
+*   - one thread per receiver, blocking in delay() the way a sketch would.
+* For each it reports host CPU time, threads, memory set aside per receiver
+* (coroutine frames versus thread stacks) and, for the coroutine runs, the
+* simulated time the session took. Once one bus can't keep up with all the
+* receivers, that time grows past the single receiver figure.
+*
+* BUILDING AND RUNNING:
+* From the library directory:
+*   g++ -O2 -std=c++20 -pthread -DRDA5807M_BUS_SIMULATOR -I. \
+*       RDA5807M_Benchmark/Coroutines.cpp RDA5807M.cpp RDA5807M-Coroutine.cpp \
+*       RDA5807M-Simulator.cpp RDA5807M-Host.cpp -o coroutines
+*   ./coroutines
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <thread>
+
+#include "RDA5807M.h"
+#include "RDA5807M-Coroutine.h"
+
+#define MAX_RADIOS 256
+#define GROUPS 10
+#define STATIONS 3
+
+static const word stations[STATIONS] = {8930, 9780, 10440};
+
+typedef struct {
+    RDA5807MSimulator chip;
+    RDA5807M radio;
+    unsigned long groups;
+    bool ok;
+} TReceiver;
+
+static TReceiver receivers[MAX_RADIOS];
+
+static double cpuMillis(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+};
+
+static void setUp(word count) {
+    for(word i = 0; i < count; i++) {
+        TReceiver &receiver = receivers[i];
+
+        receiver.chip.reset();
+        receiver.chip.clearStations();
+        for(byte s = 0; s < STATIONS; s++)
+            receiver.chip.addStation(stations[s], 40, true, 0xC000 + i,
+                                     "BENCH");
+        receiver.radio.getBus().attach(receiver.chip);
+        receiver.radio.begin(RDA5807M_BAND_WEST);
+        receiver.groups = 0;
+        receiver.ok = false;
+    };
+};
+
+//The session, as a coroutine...
+static RDA5807MTask session(RDA5807MAsync &async, TReceiver &receiver,
+                            word station) {
+    if (co_await async.tune(station) != RDA5807M_TUNER_SETTLED)
+        co_return;
+    while (receiver.groups < GROUPS) {
+        const TRDA5807MStatus &status = co_await async.nextGroup();
+
+        if (status.rds[0] == 0xC000 + (&receiver - receivers))
+            receiver.groups++;
+    };
+    for(byte i = 0; i < 2; i++)
+        if (co_await async.seek(true) != RDA5807M_TUNER_SETTLED)
+            co_return;
+    receiver.ok = true;
+};
+
+//...and blocking, the way a sketch does it
+static void blockingSession(TReceiver &receiver, word station) {
+    RDA5807M &radio = receiver.radio;
+
+    radio.setFrequency(station);
+    while (radio.poll() < RDA5807M_TUNER_SETTLED)
+        delay(1);
+    if (radio.getTunerState() != RDA5807M_TUNER_SETTLED)
+        return;
+    while (receiver.groups < GROUPS) {
+        const TRDA5807MStatus &status = radio.getStatus();
+
+        if ((status.status & RDA5807M_STATUS_RDSR) &&
+            status.rds[0] == 0xC000 + (&receiver - receivers))
+            receiver.groups++;
+        delay(RDA5807M_CORO_RDS_POLL_MS);
+    };
+    for(byte i = 0; i < 2; i++) {
+        radio.seekUp();
+        while (radio.poll() < RDA5807M_TUNER_SETTLED)
+            delay(1);
+        if (radio.getTunerState() != RDA5807M_TUNER_SETTLED)
+            return;
+    };
+    receiver.ok = true;
+};
+
+static void edge(void *context) {
+    ((RDA5807MAsync *)context)->handleInterrupt();
+};
+
+static word countOK(word count) {
+    word ok = 0;
+
+    for(word i = 0; i < count; i++)
+        if (receivers[i].ok)
+            ok++;
+
+    return ok;
+};
+
+static void runCoroutines(word count, bool interrupts) {
+    static RDA5807MAsync *asyncs[MAX_RADIOS];
+    RDA5807MScheduler scheduler;
+
+    setUp(count);
+    for(word i = 0; i < count; i++) {
+        asyncs[i] = new RDA5807MAsync(receivers[i].radio, scheduler);
+        if (interrupts) {
+            receivers[i].chip.setInterruptHandler(edge, asyncs[i]);
+            receivers[i].radio.enableInterrupts();
+        } else
+            receivers[i].chip.setInterruptHandler(NULL, NULL);
+    };
+
+    const unsigned long start = RDA5807MSimulator::now();
+    const double cpu = cpuMillis();
+
+    for(word i = 0; i < count; i++)
+        session(*asyncs[i], receivers[i], stations[i % STATIONS]);
+    const unsigned long frames = RDA5807MTask::getFrameBytes();
+    scheduler.run();
+
+    const TRDA5807MSchedulerStats &stats = scheduler.getStats();
+
+    printf("%-22s %5u %9.1f %7u %10lu %10.1f %8lu %5u/%u\n",
+           interrupts ? "coroutines (irq)" : "coroutines (polled)", count,
+           cpuMillis() - cpu, 1, frames / count,
+           (RDA5807MSimulator::now() - start) / 1000.0, stats.polls,
+           countOK(count), count);
+    for(word i = 0; i < count; i++) {
+        if (interrupts)
+            receivers[i].radio.disableInterrupts();
+        receivers[i].chip.setInterruptHandler(NULL, NULL);
+        delete asyncs[i];
+    };
+};
+
+static void runThreads(word count) {
+    static std::thread threads[MAX_RADIOS];
+    pthread_attr_t attributes;
+    size_t stack;
+
+    pthread_attr_init(&attributes);
+    pthread_attr_getstacksize(&attributes, &stack);
+    pthread_attr_destroy(&attributes);
+    setUp(count);
+
+    const double cpu = cpuMillis();
+
+    for(word i = 0; i < count; i++)
+        threads[i] = std::thread(blockingSession, std::ref(receivers[i]),
+                                 stations[i % STATIONS]);
+    for(word i = 0; i < count; i++)
+        threads[i].join();
+
+    //Each thread ran on its own simulated clock, as if on its own bus
+    printf("%-22s %5u %9.1f %7u %10lu %10s %8s %5u/%u\n", "thread per radio",
+           count, cpuMillis() - cpu, count, (unsigned long)stack, "-", "-",
+           countOK(count), count);
+};
+
+int main(void) {
+    static const word counts[] = {1, 8, 64, 256};
+
+    RDA5807MSimulator::installClock();
+    printf("%-22s %5s %9s %7s %10s %10s %8s %7s\n", "design", "radios",
+           "cpu (ms)", "threads", "bytes/radio", "sim (ms)", "checks", "done");
+    for(byte i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        runCoroutines(counts[i], false);
+        runCoroutines(counts[i], true);
+        runThreads(counts[i]);
+    };
+
+    return 0;
+};
@@ -0,0 +1,129 @@
+/*
+* RDA5807M Linux i2c-dev Backend Benchmark
+*
+* This host program counts the syscalls the Linux i2c-dev backend needs for
+* the common driver operations, against a fake device standing in for the
+* chip, and compares them with what a naive write()/read() port would need
+* (one syscall per I2C message). It also checks that reads larger than the
+* receive buffer are cut down to it and that a failed read leaves nothing to
+* read() but 0xFF. Exits with status 1 if either check fails.
+*
+* BUILDING AND RUNNING:
+* From the library directory:
+*   g++ -O2 -DRDA5807M_BUS_LINUX -I. RDA5807M_Benchmark/LinuxBus.cpp \
+*       RDA5807M.cpp RDA5807M-Linux.cpp RDA5807M-Host.cpp -o linuxbus
+*   ./linuxbus
+*/
+
+#include <stdio.h>
+
+#include "RDA5807M.h"
+
+//Just enough of the chip to answer: random access on RDA5807M_I2C_ADDR_RANDOM,
+//sequential access on RDA5807M_I2C_ADDR_SEQRDA.
+struct FakeDevice {
+    word regs[RDA5807M_LAST_REGISTER + 1];
+    byte pointer;
+    unsigned long messages;
+    word longest; //Longest message seen
+    bool broken; //Fail every transfer
+};
+
+static int fakeTransfer(void *context, struct i2c_msg msgs[], int count) {
+    FakeDevice *chip = (FakeDevice *)context;
+
+    if (chip->broken)
+        return -1;
+
+    for(int m = 0; m < count; m++) {
+        const struct i2c_msg &msg = msgs[m];
+        const bool random = (msg.addr == 0x11);
+        byte reg;
+        int i = 0;
+
+        chip->messages++;
+        if (msg.len > chip->longest)
+            chip->longest = msg.len;
+        if (msg.flags & I2C_M_RD) {
+            reg = random ? chip->pointer : RDA5807M_FIRST_REGISTER_READ;
+            for(; i + 1 < msg.len && reg <= RDA5807M_LAST_REGISTER;
+                i += 2, reg++) {
+                msg.buf[i] = highByte(chip->regs[reg]);
+                msg.buf[i + 1] = lowByte(chip->regs[reg]);
+            };
+        } else {
+            if (random) {
+                chip->pointer = msg.buf[0];
+                i = 1;
+            };
+            reg = random ? chip->pointer : RDA5807M_FIRST_REGISTER_WRITE;
+            for(; i + 1 < msg.len; i += 2, reg++)
+                chip->regs[reg] = word(msg.buf[i], msg.buf[i + 1]);
+        };
+        //Tunes complete instantly
+        chip->regs[RDA5807M_REG_STATUS] |= RDA5807M_STATUS_STC;
+    };
+
+    return count;
+};
+
+static FakeDevice chip;
+static RDA5807M radio;
+
+static void report(const char *operation, unsigned long syscalls,
+                   unsigned long messages) {
+    printf("%-24s %8lu %8lu\n", operation, syscalls, messages);
+};
+
+#define MEASURE(name, code) do { \
+        const unsigned long syscalls = radio.getBus().getSyscalls(); \
+        const unsigned long messages = chip.messages; \
+        code; \
+        report(name, radio.getBus().getSyscalls() - syscalls, \
+               chip.messages - messages); \
+    } while (0)
+
+int main(void) {
+    chip.regs[RDA5807M_REG_CHIPID] = 0x5804;
+    radio.getBus().setTransfer(fakeTransfer, &chip);
+
+    printf("%-24s %8s %8s\n", "operation", "ioctl", "naive");
+    MEASURE("begin", radio.begin(RDA5807M_BAND_WEST));
+    MEASURE("getRegister", radio.getRegister(RDA5807M_REG_STATUS));
+    MEASURE("getFrequency", radio.getFrequency());
+    MEASURE("getRSSI", radio.getRSSI());
+    MEASURE("getStatus", radio.getStatus());
+    MEASURE("volumeUp", radio.volumeUp());
+    MEASURE("setFrequency", radio.setFrequency(10110));
+    MEASURE("batch (4 registers)",
+            radio.beginBatch();
+            radio.unMute(true);
+            radio.updateRegister(RDA5807M_REG_I2S, 0x0000, 0x0000);
+            radio.updateRegister(RDA5807M_REG_FREQ, 0xFFFF, 0x0100);
+            radio.commit());
+    MEASURE("batch (2 registers)",
+            radio.beginBatch();
+            radio.updateRegister(RDA5807M_REG_GPIO, 0x0000, 0x0000);
+            radio.updateRegister(RDA5807M_REG_FREQ, 0xFFFF, 0x0200);
+            radio.commit());
+
+    RDA5807MBus &bus = radio.getBus();
+    bool failed = false;
+
+    //More than the receive buffer holds, sequential access
+    chip.longest = 0;
+    if (bus.requestFrom(0x10, 255, true) !=
+        RDA5807M_LINUX_BUFFER || chip.longest > RDA5807M_LINUX_BUFFER) {
+        printf("FAILED: oversized read not cut down to the buffer\n");
+        failed = true;
+    };
+    //Nothing read, nothing left over from the read before
+    chip.broken = true;
+    if (bus.requestFrom(0x10, 2, true) ||
+        bus.read() != 0xFF || bus.read() != 0xFF) {
+        printf("FAILED: failed read returned data\n");
+        failed = true;
+    };
+
+    return failed ? 1 : 0;
+};
@@ -0,0 +1,124 @@
+/*
+* RDA5807M Multi-receiver Manager Benchmark
+*
+* This host program runs RDA5807MManager against 64 simulated chips on four
+* buses, each bus with two multiplexers of eight channels. Radios are added in
+* an order that jumps between multiplexers on purpose. It checks that every
+* radio really talks to its own chip (right RSSI and RDS PI), that a sweep
+* switches each multiplexer channel only once and reports the throughput in
+* simulated time. Exits with status 1 if any check fails.
+*
+* BUILDING AND RUNNING:
+* From the library directory:
+*   g++ -O2 -pthread -DRDA5807M_BUS_SIMULATOR -I. \
+*       RDA5807M_Benchmark/Manager.cpp RDA5807M.cpp RDA5807M-Manager.cpp \
+*       RDA5807M-Simulator.cpp RDA5807M-Host.cpp -o manager
+*   ./manager
+*/
+
+#include <stdio.h>
+
+#include "RDA5807M.h"
+#include "RDA5807M-Manager.h"
+
+#define BUSES 4
+#define MUXES 2
+#define CHANNELS 8
+#define RADIOS (BUSES * MUXES * CHANNELS)
+#define SWEEPS 50
+#define PERIOD_MS 100
+
+//Multiplexer writes a sweep may take on one bus: a switch per channel plus
+//closing the multiplexer that's done with, for each multiplexer
+#define SWEEP_MUX_WRITES (MUXES * (CHANNELS + 1))
+
+//Declared before the manager, which talks to them on its way out
+static RDA5807MSimulator chips[RADIOS];
+static RDA5807MSimulatorMux muxes[BUSES][MUXES] = {
+    {RDA5807MSimulatorMux(0x70), RDA5807MSimulatorMux(0x71)},
+    {RDA5807MSimulatorMux(0x70), RDA5807MSimulatorMux(0x71)},
+    {RDA5807MSimulatorMux(0x70), RDA5807MSimulatorMux(0x71)},
+    {RDA5807MSimulatorMux(0x70), RDA5807MSimulatorMux(0x71)}};
+static RDA5807MManager manager;
+
+static word frequencies[RADIOS];
+static TRDA5807MSample samples[RADIOS];
+static word seenPI[RADIOS];
+
+static byte expectedRSSI(byte index) {
+    return 30 + index % 64;
+};
+
+int main(void) {
+    bool failed = false;
+
+    RDA5807MSimulator::installClock();
+    for(byte i = 0; i < RADIOS; i++) {
+        //Hop to another bus, then another multiplexer, with every radio
+        const byte bus = i % BUSES;
+        const byte mux = (i / BUSES) % MUXES;
+        const byte channel = i / (BUSES * MUXES);
+        char ps[9];
+
+        frequencies[i] = 8750 + i * 30;
+        snprintf(ps, sizeof(ps), "RADIO %02u", i);
+        chips[i].addStation(frequencies[i], expectedRSSI(i), true,
+                            0xC000 + i, ps);
+        chips[i].setMux(&muxes[bus][mux], channel);
+        if (manager.add(bus, muxes[bus][mux].getAddress(), channel) != i)
+            failed = true;
+        manager.getRadio(i).getBus().attach(chips[i]);
+    };
+
+    manager.begin(RDA5807M_BAND_WEST);
+    const byte settled = manager.tune(frequencies);
+
+    manager.clearStats();
+    for(word sweep = 0; sweep < SWEEPS; sweep++) {
+        manager.sample(samples, PERIOD_MS);
+        for(byte i = 0; i < RADIOS; i++)
+            if (samples[i].rds &&
+                !(samples[i].status.rssi & RDA5807M_BLERA_MASK))
+                seenPI[i] = samples[i].status.rds[0];
+    };
+
+    const TRDA5807MManagerStats stats = manager.getStats();
+    byte rssiOK = 0, piOK = 0;
+
+    for(byte i = 0; i < RADIOS; i++) {
+        if (samples[i].rssi == expectedRSSI(i))
+            rssiOK++;
+        if (seenPI[i] == 0xC000 + i)
+            piOK++;
+    };
+
+    printf("radios %u on %u buses, %u multiplexer channels each\n", RADIOS,
+           BUSES, MUXES * CHANNELS);
+    printf("settled after tune             %8u / %u\n", settled, RADIOS);
+    printf("right RSSI                     %8u / %u\n", rssiOK, RADIOS);
+    printf("right RDS PI                   %8u / %u\n", piOK, RADIOS);
+    printf("sweeps                         %8lu\n", stats.sweeps);
+    printf("radio visits                   %8lu\n", stats.visits);
+    printf("multiplexer writes per sweep   %8.1f (ungrouped: %u)\n",
+           (double)stats.muxWrites / stats.sweeps, 2 * RADIOS);
+    printf("RDS groups                     %8lu\n", stats.rdsGroups);
+    printf("simulated time (ms)            %8.1f\n", stats.micros / 1000.0);
+    printf("samples per simulated second   %8.1f\n",
+           stats.visits * 1000000.0 / stats.micros);
+    for(byte bus = 0; bus < BUSES; bus++) {
+        const TRDA5807MManagerStats &busStats = manager.getStats(bus);
+
+        printf("bus %u: %lu visits, %lu multiplexer writes, %.1fms busy\n",
+               bus, busStats.visits, busStats.muxWrites,
+               busStats.micros / 1000.0);
+        if (busStats.muxWrites > SWEEPS * SWEEP_MUX_WRITES)
+            failed = true;
+    };
+
+    if (settled != RADIOS || rssiOK != RADIOS || piOK != RADIOS)
+        failed = true;
+    if (failed)
+        printf("\nFAILED\n");
+
+    return failed ? 1 : 0;
+};
@@ -0,0 +1,676 @@
+/*
+* RDA5807M Benchmark
+*
+* This host program runs every public RDA5807M operation, plus a few
+* realistic scenarios, against the chip simulator and reports what each one
+* cost: simulated time, host CPU time, I2C transactions (start to stop),
+* bytes on the bus and the time those would take on a 400kHz bus. Each result is
+* checked against the budget in Budgets.h (transactions, bytes and simulated
+* time) and the program exits with status 1 if any of them is exceeded, so a
+* change that quietly adds bus traffic or latency to an operation shows up as
+* a failure. For the startup scenarios, simulated time is time-to-audio.
+* Separately, it checks that each operation did what it should (tuned where
+* it was told, found the stations, decoded their RDS...) and reports any that
+* didn't as WRONG, which fails the run too, budgets or not.
+*
+* The simulator is deterministic, so the numbers only change when the driver
+* does. After a deliberate change, run with -u to print a new Budgets.h.
+* Run with -v to also see the per-operation breakdown gathered by the
+* instrumentation layer over the whole run.
+*
+* BUILDING AND RUNNING:
+* From the library directory:
+*   g++ -O2 -DRDA5807M_BUS_SIMULATOR -DRDA5807M_INSTRUMENTATION -I. \
+*       RDA5807M_Benchmark/RDA5807M_Benchmark.cpp RDA5807M.cpp \
+*       RDA5807M-RDS.cpp RDA5807M-RDSPoller.cpp RDA5807M-Presets.cpp \
+*       RDA5807M-AF.cpp RDA5807M-RDSCapture.cpp RDA5807M-Simulator.cpp \
+*       RDA5807M-Instrumentation.cpp RDA5807M-Host.cpp -o benchmark
+*   ./benchmark [-u] [-v]
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "RDA5807M.h"
+#include "RDA5807M-AF.h"
+#include "RDA5807M-Presets.h"
+#include "RDA5807M-RDS.h"
+#include "RDA5807M-RDSCapture.h"
+#include "RDA5807M-RDSPoller.h"
+#include "RDA5807M-RDSQueue.h"
+
+typedef struct {
+    const char *name;
+    unsigned long transactions;
+    unsigned long bytes;
+    unsigned long micros; //Simulated time
+} TBudget;
+
+#include "Budgets.h"
+
+static RDA5807MSimulator chip;
+static RDA5807M radio;
+static RDA5807MRDS rds;
+static RDA5807MPresets bank;
+static RDA5807MRDSPoller poller(radio);
+static RDA5807MRDSQueue<16> queue;
+static RDA5807MAFFollower follower(radio, rds);
+static RDA5807MRDSCapture<32> capture;
+static RDA5807MRDSReplay replay;
+static RDA5807MRDS replayed;
+
+//What captureRDS() recorded: header and records, as a file would hold them
+static byte captured[RDA5807M_CAPTURE_HEADER_SIZE +
+                     1024 * RDA5807M_CAPTURE_RECORD_SIZE];
+static unsigned long capturedSize;
+static word capturedFrequency;
+
+//Stations on the simulated dial, strongest last
+static const word presets[] = {8810, 9450, 10110, 9060, 10440, 8930, 9780,
+                               10620};
+static const char *names[] = {"ALPHA", "BRAVO", "CHARLIE", "DELTA", "ECHO",
+                              "FOXTROT", "GOLF", "HOTEL"};
+
+static bool update = false, overBudget = false, wrong = false;
+
+//Measurement in progress
+static unsigned long startSim;
+static TRDA5807MSimStats startStats;
+static struct timespec startWall;
+
+static void start(void) {
+    startSim = RDA5807MSimulator::now();
+    startStats = chip.getStats();
+    clock_gettime(CLOCK_MONOTONIC, &startWall);
+};
+
+static void finish(const char *name) {
+    struct timespec wall;
+    const TRDA5807MSimStats &stats = chip.getStats();
+    const unsigned long transactions =
+        stats.transactions - startStats.transactions;
+    const unsigned long bytes = stats.bytes - startStats.bytes;
+    //Same framing as the simulator uses: start, address and data bytes with
+    //their ACKs, stop
+    const unsigned long bits = stats.bits - startStats.bits;
+    const unsigned long elapsed = RDA5807MSimulator::now() - startSim;
+    const TBudget *budget = NULL;
+
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    for(size_t i = 0; i < sizeof(budgets) / sizeof(budgets[0]); i++)
+        if (!strcmp(budgets[i].name, name))
+            budget = &budgets[i];
+
+    if (update) {
+        printf("    {\"%s\", %lu, %lu, %lu},\n", name, transactions, bytes,
+               elapsed);
+        return;
+    };
+
+    const char *verdict = "ok";
+
+    if (!budget)
+        verdict = "NO BUDGET";
+    else if (transactions > budget->transactions || bytes > budget->bytes ||
+             elapsed > budget->micros)
+        verdict = "OVER";
+    if (verdict[0] != 'o')
+        overBudget = true;
+
+    printf("%-28s %10.1f %9.1f %7lu %8lu %10lu %9lu %s\n", name,
+           elapsed / 1000.0,
+           ((wall.tv_sec - startWall.tv_sec) * 1000000000L +
+            (wall.tv_nsec - startWall.tv_nsec)) / 1000.0,
+           transactions, bytes, bits * 1000000UL / 400000UL,
+           budget ? budget->transactions : 0, verdict);
+};
+
+//Checks what an operation did, as opposed to what it cost
+static void expect(const char *what, bool ok) {
+    if (ok)
+        return;
+
+    wrong = true;
+    //Keep a Budgets.h being printed clean
+    fprintf(update ? stderr : stdout, "WRONG: %s\n", what);
+};
+
+#define MEASURE(name, code) do { \
+        start(); \
+        code; \
+        finish(name); \
+    } while (0)
+
+static void settle(void) {
+    while (radio.poll() < RDA5807M_TUNER_SETTLED)
+        delay(1);
+};
+
+//Whether the decoder has the RDS of the given preset
+static bool decoded(RDA5807MRDS &decoder, byte preset) {
+    return decoder.getPI() == 0xC201 + preset &&
+        !strncmp(decoder.getPS(), names[preset], strlen(names[preset]));
+};
+
+static void edge(void *context) {
+    ((RDA5807M *)context)->handleInterrupt();
+};
+
+static void rdsReady(const TRDA5807MStatus &status) {
+    rds.decode(status);
+};
+
+static void rdsQueue(const TRDA5807MStatus &status) {
+    queue.push(status, millis());
+};
+
+static void rdsCapture(const TRDA5807MStatus &status) {
+    rds.decode(status);
+    capture.push(status, capturedFrequency, millis());
+};
+
+//Polls for RDS the way a sketch without interrupts would, for the given
+//number of seconds.
+static void pollRDS(word seconds) {
+    const unsigned long end = millis() + seconds * 1000UL;
+
+    while ((long)(millis() - end) < 0) {
+        rds.decode(radio.getStatus());
+        delay(40);
+    };
+};
+
+//Fetches RDS through RDA5807MRDSPoller from a loop coming around every
+//millisecond, for the given number of seconds.
+static void pacedRDS(word seconds) {
+    const unsigned long end = millis() + seconds * 1000UL;
+    TRDA5807MRDSGroup group;
+
+    while ((long)(millis() - end) < 0) {
+        if (poller.service(group))
+            rds.decode(group);
+        delay(1);
+    };
+};
+
+//Services interrupts the way a sketch would, for the given number of
+//seconds.
+static void serviceRDS(word seconds) {
+    const unsigned long end = millis() + seconds * 1000UL;
+
+    while ((long)(millis() - end) < 0) {
+        radio.poll();
+        delay(1);
+    };
+};
+
+//Same, but with the RDS callback queueing groups and the loop decoding them
+//in batches, as a sketch with a slow main loop would.
+static void drainRDS(word seconds) {
+    const unsigned long end = millis() + seconds * 1000UL;
+    TRDA5807MRDSGroup group;
+
+    while ((long)(millis() - end) < 0) {
+        for(byte i = 0; i < 200; i++) {
+            radio.poll();
+            delay(1);
+        };
+        while (queue.pop(group))
+            rds.decode(group);
+    };
+};
+
+//Same, but with the RDS callback also recording groups and the loop
+//appending them to a capture, straight from the ring, as a sketch logging to
+//an SD card would.
+static void captureRDS(word seconds) {
+    const unsigned long end = millis() + seconds * 1000UL;
+    const byte *run;
+    byte count;
+
+    RDA5807MCaptureHeader(captured);
+    capturedSize = RDA5807M_CAPTURE_HEADER_SIZE;
+    while ((long)(millis() - end) < 0) {
+        for(byte i = 0; i < 200; i++) {
+            radio.poll();
+            delay(1);
+        };
+        while ((run = capture.peek(count)) && count) {
+            const unsigned long size = count * RDA5807M_CAPTURE_RECORD_SIZE;
+
+            if (capturedSize + size <= sizeof(captured)) {
+                memcpy(captured + capturedSize, run, size);
+                capturedSize += size;
+            };
+            capture.release(count);
+        };
+    };
+};
+
+//Replays the capture through the simulated chip, serviced the way
+//serviceRDS() does, until every group has been decoded.
+static void replayRDS(void) {
+    replay.open(captured, capturedSize);
+    while (!replay.isFinished() ||
+           rds.getStatistics().received < replay.getCount()) {
+        replay.service(chip);
+        radio.poll();
+        delay(1);
+    };
+};
+
+//Whether a scan found exactly the given stations, with the PI the simulator
+//gives each preset if asked to look for it.
+static bool scanFound(const TRDA5807MStation stations[], byte count,
+                      const word expected[], byte size, bool pi) {
+    if (count != size)
+        return false;
+
+    for(byte i = 0; i < size; i++) {
+        byte j = 0, k = 0;
+
+        while (j < count && stations[j].frequency != expected[i])
+            j++;
+        while (presets[k] != expected[i])
+            k++;
+        if (j == count || (pi && stations[j].pi != 0xC201 + k))
+            return false;
+    };
+
+    return true;
+};
+
+static void report(void) {
+    char name[24];
+
+    printf("\n%-20s %6s %8s %8s %6s %12s  latency histogram (<%uus, x2...)\n",
+           "operation", "calls", "messages", "bytes", "nacks", "time (us)",
+           RDA5807M_HISTOGRAM_BASE);
+    for(byte op = 0; op < RDA5807M_OP_COUNT; op++) {
+        const TRDA5807MOpStats &stats = RDA5807MInstrumentation::getStats(op);
+
+        if (!stats.calls && !stats.transactions)
+            continue;
+        RDA5807MInstrumentation::getName(op, name, sizeof(name));
+        printf("%-20s %6u %8lu %8lu %6u %12lu ", name, stats.calls,
+               stats.transactions, stats.bytes, stats.nacks, stats.micros);
+        for(byte i = 0; i < RDA5807M_HISTOGRAM_BUCKETS; i++)
+            printf(" %u", stats.histogram[i]);
+        printf("\n");
+    };
+};
+
+int main(int argc, char *argv[]) {
+    bool verbose = false;
+    static const word coarse[] = {10110, 9060, 10440, 8930, 9780, 10620};
+    TRDA5807MStation stations[32];
+    byte found;
+    bool unsupported;
+    word regs[RDA5807M_STATUS_SIZE], image[RDA5807M_SHADOW_SIZE];
+    TRDA5807MRegisterFileRead readFile;
+    TRDA5807MRegisterFileWrite writeFile;
+    TRDA5807MRDSGroup group;
+
+    for(int i = 1; i < argc; i++)
+        if (!strcmp(argv[i], "-u"))
+            update = true;
+        else if (!strcmp(argv[i], "-v"))
+            verbose = true;
+
+    RDA5807MSimulator::installClock();
+    chip.setChipID(0x5804);
+    chip.setInterruptHandler(edge, &radio);
+    for(byte i = 0; i < sizeof(presets) / sizeof(presets[0]); i++)
+        chip.addStation(presets[i], 20 + i * 5, i & 1, 0xC201 + i, names[i]);
+    radio.getBus().attach(chip);
+    RDA5807MInstrumentation::clear();
+
+    if (update)
+        printf("//Budgets for RDA5807M_Benchmark: I2C transactions, bytes and\n"
+               "//simulated microseconds each operation or scenario may use.\n"
+               "//Generated with RDA5807M_Benchmark -u, see there.\n"
+               "static const TBudget budgets[] = {\n");
+    else
+        printf("%-28s %10s %9s %7s %8s %10s %9s\n", "operation", "sim (ms)",
+               "cpu (us)", "xfers", "bytes", "bus (us)", "budget");
+
+    //Power on to audio on a known station
+    MEASURE("cold begin",
+            radio.begin(RDA5807M_BAND_WEST);
+            radio.setFrequency(presets[0]);
+            settle());
+    expect("cold begin: tuned", radio.getFrequency() == presets[0]);
+    //The same, from a precomputed register file image
+    RDA5807M::makeImage(writeFile, RDA5807M_BAND_WEST, presets[0]);
+    chip.reset();
+    MEASURE("cold begin (image)",
+            radio.begin(writeFile);
+            settle());
+    expect("cold begin (image): tuned", radio.getFrequency() == presets[0]);
+
+    MEASURE("setRegister", radio.setRegister(RDA5807M_REG_GPIO, 0x0000));
+    MEASURE("getRegister", radio.getRegister(RDA5807M_REG_STATUS));
+    MEASURE("getShadowRegister",
+            radio.getShadowRegister(RDA5807M_REG_VOLUME));
+    MEASURE("updateRegister",
+            radio.updateRegister(RDA5807M_REG_VOLUME,
+                                 RDA5807M_VOLUME_MASK, 0x0008));
+    MEASURE("resync", radio.resync());
+    MEASURE("commit (3 registers)",
+            radio.beginBatch();
+            radio.updateRegister(RDA5807M_REG_GPIO, 0x0000, 0x0000);
+            radio.updateRegister(RDA5807M_REG_VOLUME, 0x0000, 0x0000);
+            radio.updateRegister(RDA5807M_REG_I2S, 0x0000, 0x0000);
+            radio.commit());
+    MEASURE("getRegisterBulk", radio.getRegisterBulk(RDA5807M_STATUS_SIZE,
+                                                     regs));
+    MEASURE("volumeUp", radio.volumeUp());
+    MEASURE("volumeDown", radio.volumeDown());
+    MEASURE("mute", radio.mute());
+    MEASURE("unMute", radio.unMute());
+    MEASURE("getFrequency", radio.getFrequency());
+    MEASURE("getRSSI", radio.getRSSI());
+    MEASURE("isStereo", radio.isStereo());
+    MEASURE("readRDSGroup", radio.readRDSGroup(group));
+    MEASURE("getStatus", radio.getStatus());
+    MEASURE("tick (idle)", radio.poll());
+    MEASURE("setFrequency", radio.setFrequency(presets[2]));
+    MEASURE("setFrequency + settle",
+            radio.setFrequency(presets[1]);
+            settle());
+    expect("setFrequency: tuned", radio.getFrequency() == presets[1]);
+    for(byte i = 0; i < sizeof(presets) / sizeof(presets[0]); i++)
+        bank.set(i, presets[i]);
+    MEASURE("recall", bank.recall(2, radio));
+    settle();
+    expect("recall: tuned", radio.getFrequency() == presets[2]);
+    MEASURE("seekUp + settle",
+            radio.seekUp();
+            settle());
+    expect("seekUp: next station up",
+           radio.getTunerState() == RDA5807M_TUNER_SETTLED &&
+           radio.getFrequency() == presets[4]);
+    MEASURE("seekDown + settle",
+            radio.seekDown();
+            settle());
+    expect("seekDown: next station down",
+           radio.getTunerState() == RDA5807M_TUNER_SETTLED &&
+           radio.getFrequency() == presets[2]);
+    //Writing CONFIG from the shadow copy mid-seek must not abort the seek
+    MEASURE("mute during seek",
+            radio.seekUp();
+            delay(20);
+            radio.mute();
+            settle());
+    expect("mute during seek: seek completed",
+           radio.getTunerState() == RDA5807M_TUNER_SETTLED &&
+           radio.getFrequency() == presets[4]);
+    radio.unMute();
+    //Same for a sequential write, which resends CONFIG even though it's clean
+    MEASURE("commit during seek",
+            radio.seekDown();
+            delay(20);
+            radio.beginBatch();
+            radio.updateRegister(RDA5807M_REG_GPIO, 0x0000, 0x0000);
+            radio.updateRegister(RDA5807M_REG_VOLUME, 0x0000, 0x0000);
+            radio.updateRegister(RDA5807M_REG_I2S, 0x0000, 0x0000);
+            radio.commit();
+            settle());
+    expect("commit during seek: seek completed",
+           radio.getTunerState() == RDA5807M_TUNER_SETTLED &&
+           radio.getFrequency() == presets[2]);
+    //Nobody polls this seek, once it's over muting must not start another
+    MEASURE("mute after unpolled seek",
+            radio.seekUp();
+            delay(1000);
+            radio.mute();
+            radio.unMute();
+            delay(1000));
+    expect("mute after unpolled seek: stayed put",
+           radio.getTunerState() == RDA5807M_TUNER_SETTLED &&
+           chip.getFrequency() == presets[4]);
+    radio.seekDown();
+    settle();
+    MEASURE("setBand", radio.setBand(RDA5807M_BAND_WEST));
+    MEASURE("setDirectFrequency + settle",
+            radio.setDirectFrequency(presets[2] + 5);
+            settle());
+    expect("setDirectFrequency: tuned",
+           radio.getFrequency() == presets[2] + 5 &&
+           chip.getFrequency() == presets[2] + 5);
+    MEASURE("setFrequency (from direct)", radio.setFrequency(presets[2]));
+    settle();
+    expect("setFrequency (from direct): tuned",
+           radio.getFrequency() == presets[2] &&
+           chip.getFrequency() == presets[2]);
+    //Direct mode doesn't depend on the channel spacing, so it must land on
+    //the same frequency with any of them
+    for(byte space = RDA5807M_SPACE_200K; space <= RDA5807M_SPACE_50K;
+        space++) {
+        radio.updateRegister(RDA5807M_REG_TUNING, RDA5807M_SPACE_MASK, space);
+        MEASURE(space == RDA5807M_SPACE_200K ?
+                "setDirectFrequency (200k)" : "setDirectFrequency (50k)",
+                expect("setDirectFrequency: accepted",
+                       radio.setDirectFrequency(10000));
+                settle());
+        expect("setDirectFrequency: tuned, any spacing",
+               radio.getFrequency() == 10000 && chip.getFrequency() == 10000);
+    };
+    radio.updateRegister(RDA5807M_REG_TUNING, RDA5807M_SPACE_MASK,
+                         RDA5807M_SPACE_100K);
+    radio.setFrequency(presets[2]);
+    settle();
+    MEASURE("setI2S", radio.setI2S(true, RDA5807P_I2SRATE_48K));
+    radio.setI2S(false);
+    MEASURE("standby", radio.standby());
+    MEASURE("resume + settle",
+            radio.resume();
+            settle());
+    expect("resume: tuned", radio.getFrequency() == presets[2]);
+    MEASURE("enableInterrupts", radio.enableInterrupts());
+    MEASURE("disableInterrupts", radio.disableInterrupts());
+
+    MEASURE("scan",
+            found = radio.scan(stations,
+                               sizeof(stations) / sizeof(stations[0])));
+    settle();
+    expect("scan: station table",
+           scanFound(stations, found, presets,
+                     sizeof(presets) / sizeof(presets[0]), false));
+    expect("scan: back where it was", chip.getFrequency() == presets[2]);
+    MEASURE("scan (two-pass, PI)",
+            found = radio.scan(stations,
+                               sizeof(stations) / sizeof(stations[0]),
+                               RDA5807M_SCAN_TWOPASS | RDA5807M_SCAN_PI));
+    settle();
+    //The two weakest presets sit on odd channels and don't lift the 200kHz
+    //probes either side of them to the seek threshold
+    expect("scan (two-pass, PI): station table",
+           scanFound(stations, found, coarse,
+                     sizeof(coarse) / sizeof(coarse[0]), true));
+    //Probes go by channel number, the station it was playing doesn't
+    radio.setDirectFrequency(presets[2] + 5);
+    settle();
+    MEASURE("scan (from direct)",
+            found = radio.scan(stations,
+                               sizeof(presets) / sizeof(presets[0])));
+    settle();
+    expect("scan (from direct): station table",
+           scanFound(stations, found, presets,
+                     sizeof(presets) / sizeof(presets[0]), false));
+    expect("scan (from direct): back where it was",
+           radio.getFrequency() == presets[2] + 5 &&
+           chip.getFrequency() == presets[2] + 5);
+
+    MEASURE("preset hopping (8)",
+            for(byte i = 0; i < sizeof(presets) / sizeof(presets[0]); i++) {
+                radio.setFrequency(presets[i]);
+                settle();
+            });
+    expect("preset hopping: tuned", radio.getFrequency() == presets[7]);
+    MEASURE("preset hopping (8, bank)",
+            for(byte i = 0; i < sizeof(presets) / sizeof(presets[0]); i++) {
+                bank.recall(i, radio);
+                settle();
+            });
+    expect("preset hopping (bank): tuned", radio.getFrequency() == presets[7]);
+
+    rds.reset();
+    MEASURE("RDS 60s (polled)", pollRDS(60));
+    expect("RDS 60s (polled): decoded", decoded(rds, 7));
+    rds.reset();
+    poller.reset();
+    MEASURE("RDS 60s (paced)", pacedRDS(60));
+    expect("RDS 60s (paced): decoded", decoded(rds, 7));
+    expect("RDS 60s (paced): no group missed", !poller.getStats().missed);
+    if (verbose)
+        printf("paced: %lu reads, %lu groups, %lu missed, %u.%02u per group\n",
+               poller.getStats().polls, poller.getStats().captured,
+               poller.getStats().missed, poller.getPollsPerGroup() / 100,
+               poller.getPollsPerGroup() % 100);
+    radio.setFrequency(10000);
+    settle();
+    poller.reset();
+    poller.clearStats();
+    MEASURE("no RDS 60s (paced)", pacedRDS(60));
+    expect("no RDS 60s (paced): nothing", !poller.getStats().captured);
+    radio.setFrequency(presets[7]);
+    settle();
+    rds.reset();
+    radio.setRDSCallback(rdsReady);
+    radio.enableInterrupts();
+    MEASURE("RDS 60s (interrupts)", serviceRDS(60));
+    expect("RDS 60s (interrupts): decoded", decoded(rds, 7));
+    rds.reset();
+    radio.setRDSCallback(rdsQueue);
+    MEASURE("RDS 60s (queued)", drainRDS(60));
+    expect("RDS 60s (queued): decoded", decoded(rds, 7));
+    expect("RDS 60s (queued): no overflow", !queue.getOverflows());
+    rds.reset();
+    capturedFrequency = presets[7];
+    radio.setRDSCallback(rdsCapture);
+    MEASURE("RDS 60s (captured)", captureRDS(60));
+    expect("RDS 60s (captured): decoded", decoded(rds, 7));
+    expect("RDS 60s (captured): recorded, no overflow",
+           !capture.getOverflows() &&
+           capturedSize > RDA5807M_CAPTURE_HEADER_SIZE);
+    //Offline, the capture must decode to the same as it did live
+    replay.open(captured, capturedSize);
+    MEASURE("RDS replay (decoder)", replay.service(replayed));
+    expect("RDS replay (decoder): same as live",
+           replay.getCount() == rds.getStatistics().received &&
+           replayed.getStatistics().accepted == rds.getStatistics().accepted &&
+           decoded(replayed, 7));
+    if (verbose) {
+        TRDA5807MCaptureRecord record;
+        char line[RDA5807M_CAPTURE_SPY_LENGTH];
+
+        replay.open(captured, capturedSize);
+        printf("captured: %lu bytes, first groups as RDS Spy:\n",
+               capturedSize);
+        for(byte i = 0; i < 4 && replay.next(record); i++) {
+            RDA5807MCaptureSpyLine(record, line);
+            printf("  %s\n", line);
+        };
+    };
+    radio.setRDSCallback(rdsReady);
+    radio.enableInterrupts(false);
+    MEASURE("idle 60s (interrupts)", serviceRDS(60));
+    //And through the chip, on a frequency with no RDS of its own
+    radio.enableInterrupts();
+    radio.setFrequency(10000);
+    settle();
+    rds.reset();
+    MEASURE("RDS replay (simulator)", replayRDS());
+    expect("RDS replay (simulator): same as live", decoded(rds, 7));
+    radio.setFrequency(presets[7]);
+    settle();
+    radio.disableInterrupts();
+
+    for(byte i = 0; i < RDA5807M_SHADOW_SIZE; i++)
+        image[i] = radio.getShadowRegister(RDA5807M_FIRST_REGISTER_WRITE + i);
+    MEASURE("setRegisterBulk", radio.setRegisterBulk(RDA5807M_SHADOW_SIZE,
+                                                     image));
+    MEASURE("getRegisterBulk (file)", radio.getRegisterBulk(&readFile));
+    memcpy(writeFile.regs, image, sizeof(image));
+    writeFile.set(RDA5807M_FIELD_VOLUME, 4);
+    MEASURE("setRegisterBulk (file)", radio.setRegisterBulk(&writeFile));
+    expect("setRegisterBulk (file): written",
+           (chip.getRegister(RDA5807M_REG_VOLUME) & RDA5807M_VOLUME_MASK) ==
+           4);
+    const word config = chip.getRegister(RDA5807M_REG_CONFIG);
+
+    MEASURE("end", radio.end());
+    //Nothing lost but the power
+    MEASURE("resume (from end) + settle",
+            radio.resume();
+            settle());
+    expect("resume (from end): configuration and frequency back",
+           chip.getRegister(RDA5807M_REG_CONFIG) == config &&
+           radio.getFrequency() == presets[7]);
+    radio.end();
+
+    //Features the RDA5800 lacks must not cost any bus traffic
+    chip.reset();
+    chip.setChipID(RDA5800_CHIPID);
+    radio.begin(RDA5807M_BAND_WEST);
+    MEASURE("unsupported (RDA5800)",
+            unsupported = radio.enableInterrupts() || radio.setI2S(true) ||
+                radio.setBand(RDA5807M_BAND_EAST, true) ||
+                radio.setDirectFrequency(presets[2] + 5));
+    expect("unsupported (RDA5800): refused", !unsupported);
+    radio.end();
+
+    //A weak station whose AF list has a weaker transmitter, a stronger one
+    //of another programme and a stronger one of its own, probed in that order
+    chip.reset();
+    chip.setChipID(0x5804);
+    chip.clearStations();
+
+    TRDA5807MSimStation *home = chip.addStation(9000, 20, true, 0xD301,
+                                                "REGIONAL");
+    static const word afs[] = {9310, 9650, 10270};
+
+    for(byte i = 0; i < sizeof(afs) / sizeof(afs[0]); i++)
+        home->af[home->afCount++] = (afs[i] - 8750) / 10;
+    chip.addStation(afs[0], 15, true, 0xD301, "REGIONAL");
+    chip.addStation(afs[1], 45, true, 0xD302, "OTHER");
+    chip.addStation(afs[2], 35, true, 0xD301, "REGIONAL");
+    radio.begin(RDA5807M_BAND_WEST);
+    radio.setFrequency(9000);
+    settle();
+    rds.reset();
+    while (rds.getAFCount() < sizeof(afs) / sizeof(afs[0]))
+        pollRDS(1);
+    MEASURE("AF probe (weaker)", follower.probe());
+    settle();
+    MEASURE("AF probe (other PI)", follower.probe());
+    settle();
+    MEASURE("AF switch", follower.probe());
+    settle();
+    expect("AF: switched to the stronger transmitter of the same PI",
+           radio.getFrequency() == afs[2] &&
+           follower.getStats().switches == 1);
+    if (verbose)
+        printf("AF: %lu probes, %lu transactions, mute %luus max, %luus "
+               "total, dwell %ums\n", follower.getStats().probes,
+               follower.getStats().transactions,
+               follower.getStats().maxMuteMicros,
+               follower.getStats().muteMicros, follower.getDwell());
+    radio.end();
+
+    if (update) {
+        printf("};\n");
+        //Budgets of a driver that doesn't work are worth nothing
+        return wrong ? 1 : 0;
+    };
+    if (verbose)
+        report();
+    if (overBudget)
+        printf("\nFAILED: over budget (see Budgets.h)\n");
+    if (wrong)
+        printf("\nFAILED: wrong results (see WRONG above)\n");
+
+    return overBudget || wrong ? 1 : 0;
+};
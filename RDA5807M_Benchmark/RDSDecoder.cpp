@@ -0,0 +1,193 @@
+/*
+* RDA5807M RDS Decoder Test
+*
+* This host program replays recorded RDS group streams through RDA5807MRDS
+* and checks what comes out: PI, PTY, TP/TA, PS, RadioText, clock-time and
+* AF. The streams below are written out block by block from IEC 62106, with
+* the block error levels the chip would have reported, and go through the
+* same path as a real recording: packed into a capture, then handed to the
+* decoder by RDA5807MRDSReplay. Exits with status 1 if any check fails.
+*
+* Given capture files (see RDA5807M-RDSCapture.h) on the command line, it
+* also decodes each one and prints what it found, without checking anything.
+*
+* BUILDING AND RUNNING:
+* From the library directory:
+*   g++ -O2 -DRDA5807M_BUS_SIMULATOR -I. RDA5807M_Benchmark/RDSDecoder.cpp \
+*       RDA5807M-RDS.cpp RDA5807M-RDSCapture.cpp RDA5807M-Simulator.cpp \
+*       RDA5807M-Host.cpp -o rdsdecoder
+*   ./rdsdecoder [capture...]
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "RDA5807M.h"
+#include "RDA5807M-RDS.h"
+#include "RDA5807M-RDSCapture.h"
+
+//RDS group rate, in milliseconds per group
+#define GROUP_MS 88
+//Longest stream below
+#define MAX_GROUPS 16
+
+typedef struct {
+    word blocks[4];
+    byte bler; //RDA5807M_BLERA_* | RDA5807M_BLERB_*
+} TGroup;
+
+//PI D301, PTY 10, TP, received cleanly
+static const TGroup clean[] = {
+    //0A: TA, AF method A: 3 to follow, 93.1, 96.5, 102.7 and PS "REGIONAL"
+    {{0xD301, 0x0550, 0xE338, 0x5245}, RDA5807M_BLERB_0},
+    {{0xD301, 0x0551, 0x5A98, 0x4749}, RDA5807M_BLERB_0},
+    {{0xD301, 0x0552, 0xCDCD, 0x4F4E}, RDA5807M_BLERB_0},
+    {{0xD301, 0x0553, 0xE338, 0x414C}, RDA5807M_BLERB_0},
+    //2A: RadioText "NEWS AT NINE ON REGIONAL", ended by a carriage return
+    {{0xD301, 0x2540, 0x4E45, 0x5753}, RDA5807M_BLERB_0},
+    {{0xD301, 0x2541, 0x2041, 0x5420}, RDA5807M_BLERB_0},
+    {{0xD301, 0x2542, 0x4E49, 0x4E45}, RDA5807M_BLERB_0},
+    {{0xD301, 0x2543, 0x204F, 0x4E20}, RDA5807M_BLERB_0},
+    {{0xD301, 0x2544, 0x5245, 0x4749}, RDA5807M_BLERB_0},
+    {{0xD301, 0x2545, 0x4F4E, 0x414C}, RDA5807M_BLERB_0},
+    {{0xD301, 0x2546, 0x0D20, 0x2020}, RDA5807M_BLERB_0},
+    //4A: MJD 61331 (2026-10-18), 14:35 UTC, local offset -5h
+    {{0xD301, 0x4541, 0xDF26, 0xE8EA}, RDA5807M_BLERB_0}};
+
+//PI C201, PTY 0, PS "ALPHA" on a weak signal
+static const TGroup weak[] = {
+    //Block B lost: rejected, "XX" must not show
+    {{0xC201, 0x0000, 0xE15A, 0x5858}, RDA5807M_BLERA_U | RDA5807M_BLERB_U},
+    //Corrected errors: one vote for "AL", AF 96.5 ignored
+    {{0xC201, 0x0000, 0xE15A, 0x414C}, RDA5807M_BLERB_12},
+    {{0xC201, 0x0001, 0xCDCD, 0x5048}, RDA5807M_BLERB_0},
+    //Second vote: "AL" shows
+    {{0xC201, 0x0000, 0xE15A, 0x414C}, RDA5807M_BLERB_12},
+    //One vote for "QQ", outvoted by a clean "A "
+    {{0xC201, 0x0002, 0xCDCD, 0x5151}, RDA5807M_BLERB_12},
+    {{0xC201, 0x0002, 0xCDCD, 0x4120}, RDA5807M_BLERB_0},
+    //Block A lost: the group counts, its PI doesn't
+    {{0x1234, 0x0003, 0xCDCD, 0x2020}, RDA5807M_BLERA_U},
+    //4A with corrected errors: ignored
+    {{0xC201, 0x4001, 0xDF26, 0xE8EA}, RDA5807M_BLERB_12}};
+
+//PI C203: a 2A RadioText, then a 2B one with the A/B flag toggled
+static const TGroup toggled[] = {
+    {{0xC203, 0x2000, 0x4F4C, 0x4420}, RDA5807M_BLERB_0}, //"OLD "
+    {{0xC203, 0x2001, 0x5445, 0x5854}, RDA5807M_BLERB_0}, //"TEXT"
+    {{0xC203, 0x2810, 0xC203, 0x5345}, RDA5807M_BLERB_0}, //"SE"
+    {{0xC203, 0x2811, 0xC203, 0x434F}, RDA5807M_BLERB_0}, //"CO"
+    {{0xC203, 0x2812, 0xC203, 0x4E44}, RDA5807M_BLERB_0}, //"ND"
+    {{0xC203, 0x2813, 0xC203, 0x0D20}, RDA5807M_BLERB_0}}; //"\r "
+
+static byte capture[RDA5807M_CAPTURE_HEADER_SIZE +
+                    MAX_GROUPS * RDA5807M_CAPTURE_RECORD_SIZE];
+static bool failed = false;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("FAILED: %s\n", what);
+        failed = true;
+    };
+};
+
+//Records the groups into a capture as RDA5807MRDSCapture would, then replays
+//it into the decoder. Returns whether every group made it through.
+static bool replay(const TGroup groups[], byte count, RDA5807MRDS &rds) {
+    RDA5807MRDSReplay replay;
+    TRDA5807MStatus status;
+    unsigned long size = RDA5807M_CAPTURE_HEADER_SIZE;
+
+    RDA5807MCaptureHeader(capture);
+    for(byte i = 0; i < count; i++) {
+        status.status = RDA5807M_STATUS_RDSR | RDA5807M_STATUS_RDSS;
+        status.rssi = groups[i].bler;
+        memcpy(status.rds, groups[i].blocks, sizeof(status.rds));
+        RDA5807MCapturePack(capture + size, status, 10000, i * GROUP_MS);
+        size += RDA5807M_CAPTURE_RECORD_SIZE;
+    };
+
+    return replay.open(capture, size) && replay.service(rds, 0) == count &&
+        replay.isFinished();
+};
+
+static void print(const char *name, RDA5807MRDS &rds) {
+    const TRDA5807MClockTime &ct = rds.getClockTime();
+
+    printf("%s: %lu groups, %lu rejected\n", name,
+           rds.getStatistics().received, rds.getStatistics().rejected);
+    printf("  PI %04X PTY %u%s%s PS \"%s\"\n", rds.getPI(), rds.getPTY(),
+           rds.getTP() ? " TP" : "", rds.getTA() ? " TA" : "", rds.getPS());
+    printf("  RT \"%s\"\n", rds.getRadioText());
+    if (ct.mjd)
+        printf("  CT MJD %lu %02u:%02u UTC, local %+d minutes\n", ct.mjd,
+               ct.hour, ct.minute, ct.offset * 30);
+    printf("  AF");
+    for(byte i = 0; i < rds.getAFCount(); i++)
+        printf(" %u.%u", rds.getAF(i) / 100, rds.getAF(i) / 10 % 10);
+    printf("\n");
+};
+
+int main(int argc, char *argv[]) {
+    RDA5807MRDS rds;
+
+    check("clean: replay", replay(clean, sizeof(clean) / sizeof(clean[0]),
+                                  rds));
+    check("clean: PI", rds.getPI() == 0xD301);
+    check("clean: PTY", rds.getPTY() == 10);
+    check("clean: TP and TA", rds.getTP() && rds.getTA());
+    check("clean: PS", !strcmp(rds.getPS(), "REGIONAL"));
+    check("clean: RT", !strcmp(rds.getRadioText(),
+                               "NEWS AT NINE ON REGIONAL"));
+    check("clean: AF", rds.getAFCount() == 3 && rds.getAF(0) == 9310 &&
+          rds.getAF(1) == 9650 && rds.getAF(2) == 10270);
+    check("clean: CT date", rds.getClockTime().mjd == 61331);
+    check("clean: CT time", rds.getClockTime().hour == 14 &&
+          rds.getClockTime().minute == 35);
+    check("clean: CT offset", rds.getClockTime().offset == -10);
+    check("clean: changes", rds.getChanges() ==
+          (RDA5807M_RDS_PI | RDA5807M_RDS_PTY | RDA5807M_RDS_TRAFFIC |
+           RDA5807M_RDS_PS | RDA5807M_RDS_RT | RDA5807M_RDS_CT |
+           RDA5807M_RDS_AF));
+    check("clean: statistics", rds.getStatistics().accepted == 12 &&
+          !rds.getStatistics().rejected);
+    print("clean", rds);
+
+    rds.reset();
+    check("weak: replay", replay(weak, sizeof(weak) / sizeof(weak[0]), rds));
+    check("weak: PI", rds.getPI() == 0xC201);
+    check("weak: PS", !strcmp(rds.getPS(), "ALPHA   "));
+    check("weak: no AF", !rds.getAFCount());
+    check("weak: no CT", !rds.getClockTime().mjd);
+    check("weak: statistics", rds.getStatistics().received == 8 &&
+          rds.getStatistics().rejected == 1);
+    print("weak", rds);
+
+    rds.reset();
+    check("toggled: replay", replay(toggled, 2, rds));
+    check("toggled: old RT", !strncmp(rds.getRadioText(), "OLD TEXT ", 9));
+    check("toggled: replay", replay(toggled + 2, 4, rds));
+    check("toggled: new RT", !strcmp(rds.getRadioText(), "SECOND"));
+    print("toggled", rds);
+
+    for(int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        RDA5807MRDSReplay recorded;
+
+        rds.reset();
+        if (!file || !recorded.open(file)) {
+            printf("%s: not a capture\n", argv[i]);
+            failed = true;
+        } else {
+            recorded.service(rds, 0);
+            print(argv[i], rds);
+        };
+        if (file)
+            fclose(file);
+    };
+
+    if (failed)
+        printf("\nFAILED\n");
+
+    return failed ? 1 : 0;
+};
@@ -50,6 +50,20 @@ RDA5807M radio;
 char command;
 word status, frequency;
 
+//Called by the library once a seek or tune has completed
+void tuned(word frequency, byte rssi, bool failed)
+{
+  if(failed) Serial.print(F("Seek failed at "));
+  else Serial.print(F("Settled on "));
+  Serial.print(frequency / 100);
+  Serial.print(".");
+  Serial.print(frequency % 100);
+  Serial.print(F("MHz FM, RSSI = "));
+  Serial.print(rssi);
+  Serial.println("dBuV");
+  Serial.flush();
+}
+
 void setup()
 {
   //Create a serial connection
@@ -58,10 +72,15 @@ void setup()
   //Initialize the radio to the West-FM band. (see RDA5807M_BAND_* constants).
   //The mode will set the proper receiver bandwidth.
   radio.begin(RDA5807M_BAND_WEST);
+  radio.setTuneCallback(tuned);
 }
 
 void loop()
 {
+  //Let the library check on any seek in progress, this returns immediately
+  radio.poll();
+
+
   //Wait until a character comes in on the Serial port.
   if(Serial.available()){
     //Decide what to do based on the character received.
@@ -113,7 +132,7 @@ void loop()
         Serial.flush();
         break;
       case 't':
-        status = radio.getRegister(RDA5807M_REG_STATUS);
+        status = radio.getStatus().status;
         Serial.println(F("Status register {"));
         if(status & RDA5807M_STATUS_RDSR)
             Serial.println(F("* RDS Group Ready"));